@@ -195,6 +195,11 @@ namespace morphene { namespace chain {
    }
 
    uint64_t block_log::append( const signed_block& b )
+   {
+      return append( b, b.id() );
+   }
+
+   uint64_t block_log::append( const signed_block& b, const block_id_type& id )
    {
       try
       {
@@ -217,7 +222,7 @@ namespace morphene { namespace chain {
          my->block_stream.write( (char*)&pos, sizeof( pos ) );
          my->index_stream.write( (char*)&pos, sizeof( pos ) );
          my->head = b;
-         my->head_id = b.id();
+         my->head_id = id;
 
          return pos;
       }
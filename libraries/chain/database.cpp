@@ -202,9 +202,13 @@ uint32_t database::reindex( const open_args& args )
             args.benchmark.second( 0, get_abstract_index_cntr() );
          }
 
+         _benchmark_dumper.set_enabled( args.benchmark_is_enabled && args.benchmark_start_at <= 1 );
+
          while( itr.first.block_num() != last_block_num )
          {
             auto cur_block_num = itr.first.block_num();
+            if( args.benchmark_is_enabled && cur_block_num == args.benchmark_start_at )
+               _benchmark_dumper.set_enabled( true );
             if( cur_block_num % 100000 == 0 )
                std::cerr << "   " << double( cur_block_num * 100 ) / last_block_num << "%   " << cur_block_num << " of " << last_block_num <<
                "   (" << (get_free_memory() / (1024*1024)) << "M free)\n";
@@ -215,6 +219,8 @@ uint32_t database::reindex( const open_args& args )
             itr = _block_log.read_block( itr.second );
          }
 
+         if( args.benchmark_is_enabled && last_block_num == args.benchmark_start_at )
+            _benchmark_dumper.set_enabled( true );
          apply_block( itr.first, skip_flags );
          note.last_block_number = itr.first.block_num();
 
@@ -528,12 +534,13 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
    //fc::time_point begin_time = fc::time_point::now();
 
-   auto block_num = new_block.block_num();
+   hashed_block block( new_block );
+   auto block_num = block.block_num();
    if( _checkpoints.size() && _checkpoints.rbegin()->second != block_id_type() )
    {
       auto itr = _checkpoints.find( block_num );
       if( itr != _checkpoints.end() )
-         FC_ASSERT( new_block.id() == itr->second, "Block did not match checkpoint", ("checkpoint",*itr)("block_id",new_block.id()) );
+         FC_ASSERT( block.id() == itr->second, "Block did not match checkpoint", ("checkpoint",*itr)("block_id",block.id()) );
 
       if( _checkpoints.rbegin()->first >= block_num )
          skip = skip_witness_signature
@@ -558,11 +565,11 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
       {
          try
          {
-            result = _push_block(new_block);
+            result = _push_block(block);
          }
          FC_CAPTURE_AND_RETHROW( (new_block) )
 
-         check_free_memory( false, new_block.block_num() );
+         check_free_memory( false, block_num );
       });
    });
 
@@ -590,6 +597,11 @@ void database::_maybe_warn_multiple_production( uint32_t height )const
 }
 
 bool database::_push_block(const signed_block& new_block)
+{
+   return _push_block( hashed_block( new_block ) );
+}
+
+bool database::_push_block(const hashed_block& new_block)
 { try {
    #ifdef IS_TEST_NET
    FC_ASSERT(new_block.block_num() < TESTNET_BLOCK_LIMIT, "Testnet block limit exceeded");
@@ -600,7 +612,7 @@ bool database::_push_block(const signed_block& new_block)
 
    if( !(skip&skip_fork_db) )
    {
-      shared_ptr<fork_item> new_head = _fork_db.push_block(new_block);
+      shared_ptr<fork_item> new_head = _fork_db.push_block(new_block.get(), new_block.id());
       _maybe_warn_multiple_production( new_head->num );
 
       //If the head block from the longest chain does not build off of the current head, we need to switch forks.
@@ -610,8 +622,8 @@ bool database::_push_block(const signed_block& new_block)
          //Only switch forks if new_head is actually higher than head
          if( new_head->data.block_num() > head_block_num() )
          {
-            wlog( "Switching to fork: ${id}", ("id",new_head->data.id()) );
-            auto branches = _fork_db.fetch_branch_from(new_head->data.id(), head_block_id());
+            wlog( "Switching to fork: ${id}", ("id",new_head->id) );
+            auto branches = _fork_db.fetch_branch_from(new_head->id, head_block_id());
 
             // pop blocks until we hit the forked block
             while( head_block_id() != branches.second.back()->data.previous )
@@ -620,13 +632,13 @@ bool database::_push_block(const signed_block& new_block)
             // push all blocks on the new fork
             for( auto ritr = branches.first.rbegin(); ritr != branches.first.rend(); ++ritr )
             {
-                ilog( "pushing blocks from fork ${n} ${id}", ("n",(*ritr)->data.block_num())("id",(*ritr)->data.id()) );
+                ilog( "pushing blocks from fork ${n} ${id}", ("n",(*ritr)->num)("id",(*ritr)->id) );
                 optional<fc::exception> except;
                 try
                 {
                    _fork_db.set_head( *ritr );
                    auto session = start_undo_session();
-                   apply_block( (*ritr)->data, skip );
+                   apply_block( hashed_block( (*ritr)->data, (*ritr)->id ), skip );
                    session.push();
                 }
                 catch ( const fc::exception& e ) { except = e; }
@@ -636,7 +648,7 @@ bool database::_push_block(const signed_block& new_block)
                    // remove the rest of branches.first from the fork_db, those blocks are invalid
                    while( ritr != branches.first.rend() )
                    {
-                      _fork_db.remove( (*ritr)->data.id() );
+                      _fork_db.remove( (*ritr)->id );
                       ++ritr;
                    }
 
@@ -649,7 +661,7 @@ bool database::_push_block(const signed_block& new_block)
                    {
                       _fork_db.set_head( *ritr );
                       auto session = start_undo_session();
-                      apply_block( (*ritr)->data, skip );
+                      apply_block( hashed_block( (*ritr)->data, (*ritr)->id ), skip );
                       session.push();
                    }
                    throw *except;
@@ -832,7 +844,8 @@ signed_block database::_generate_block(
       if( tx.expiration < when )
          continue;
 
-      uint64_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+      size_t tx_size = fc::raw::pack_size( tx );
+      uint64_t new_total_size = total_block_size + tx_size;
 
       // postpone transaction if it would make block too big
       if( new_total_size >= maximum_block_size )
@@ -847,7 +860,7 @@ signed_block database::_generate_block(
          _apply_transaction( tx );
          temp_session.squash();
 
-         total_block_size += fc::raw::pack_size( tx );
+         total_block_size += tx_size;
          pending_block.transactions.push_back( tx );
       }
       catch ( const fc::exception& e )
@@ -870,7 +883,7 @@ signed_block database::_generate_block(
    // However, the push_block() call below will re-create the
    // _pending_tx_session.
 
-   pending_block.transaction_merkle_root = pending_block.calculate_merkle_root();
+   pending_block.transaction_merkle_root = hashed_block( pending_block ).merkle_root();
 
    if( !(skip & skip_witness_signature) )
       pending_block.sign( block_signing_private_key, fc::ecc::bip_0062 );
@@ -878,7 +891,10 @@ signed_block database::_generate_block(
    // TODO:  Move this to _push_block() so session is restored.
    if( !(skip & skip_block_size_check) )
    {
-      FC_ASSERT( fc::raw::pack_size(pending_block) <= MORPHENE_MAX_BLOCK_SIZE );
+      // total_block_size counts the empty transaction vector's length byte plus the 4 reserved above.
+      // The merkle root and signature are fixed size, so it is otherwise exact.
+      size_t block_size = total_block_size - 4 - 1 + fc::raw::pack_size( fc::unsigned_int( pending_block.transactions.size() ) );
+      FC_ASSERT( block_size <= MORPHENE_MAX_BLOCK_SIZE );
    }
 
    push_block( pending_block, skip );
@@ -1160,11 +1176,39 @@ void database::adjust_witness_votes( const account_object& a, share_type delta )
    auto itr = vidx.lower_bound( boost::make_tuple( a.name, account_name_type() ) );
    while( itr != vidx.end() && itr->account == a.name )
    {
-      adjust_witness_vote( get< witness_object, by_name >(itr->witness), delta );
+      if( _witness_vote_deltas.valid() )
+         (*_witness_vote_deltas)[ itr->witness ] += delta;
+      else
+         adjust_witness_vote( get< witness_object, by_name >(itr->witness), delta );
       ++itr;
    }
 }
 
+void database::begin_witness_vote_batch()
+{
+   FC_ASSERT( !_witness_vote_deltas.valid(), "Witness vote batches cannot be nested" );
+   _witness_vote_deltas = flat_map< account_name_type, share_type >();
+}
+
+/**
+ * The virtual schedule only depends on the current virtual time, which is constant while
+ * a batch is open, and on the final vote count. Applying the summed delta once therefore
+ * produces the same witness object as applying each delta in turn. Witnesses whose deltas
+ * cancel out are still updated, as they would have been without batching.
+ */
+void database::apply_witness_vote_deltas()
+{
+   if( !_witness_vote_deltas.valid() )
+      return;
+
+   flat_map< account_name_type, share_type > deltas;
+   std::swap( deltas, *_witness_vote_deltas );
+   _witness_vote_deltas.reset();
+
+   for( const auto& delta : deltas )
+      adjust_witness_vote( get< witness_object, by_name >( delta.first ), delta.second );
+}
+
 void database::adjust_witness_vote( const witness_object& witness, share_type delta )
 {
    const witness_schedule_object& wso = get_witness_schedule_object();
@@ -1292,6 +1336,30 @@ void database::process_vesting_withdrawals()
 
    const auto& cprops = get_dynamic_global_properties();
 
+   if( current == widx.end() || current->next_vesting_withdrawal > head_block_time() )
+      return;
+
+   // The virtual operations pushed below are timed by the same dumper with begin() and end(),
+   // so this region keeps its own start time
+   uint64_t benchmark_start = _benchmark_dumper.is_enabled() ? util::advanced_benchmark_dumper::now() : 0;
+
+   // Witnesses voted for by many withdrawing accounts are only modified once per block
+   begin_witness_vote_batch();
+   BOOST_SCOPE_EXIT( this_ )
+   {
+      this_->_witness_vote_deltas.reset();
+   } BOOST_SCOPE_EXIT_END
+
+   /**
+    * The vesting fund totals are tracked locally and written to the global properties once.
+    * Every conversion uses the price computed from the running totals, exactly as if the
+    * global properties had been modified after each withdrawal.
+    */
+   legacy_asset total_vesting_fund_morph = cprops.total_vesting_fund_morph;
+   legacy_asset total_vesting_shares = cprops.total_vesting_shares;
+
+   vector< const withdraw_vesting_route_object* > liquid_routes;
+
    while( current != widx.end() && current->next_vesting_withdrawal <= head_block_time() )
    {
       const auto& from_account = *current; ++current;
@@ -1311,77 +1379,74 @@ void database::process_vesting_withdrawals()
 
       share_type vests_deposited_as_morphene = 0;
       share_type vests_deposited_as_vests = 0;
-      legacy_asset total_morph_converted = legacy_asset( 0, MORPH_SYMBOL );
 
-      // Do two passes, the first for vests, the second for morphene. Try to maintain as much accuracy for vests as possible.
+      // Routes are visited once. Vests are deposited first and morphene after, so the virtual
+      // operations keep their order and vests keep as much accuracy as possible.
+      liquid_routes.clear();
       for( auto itr = didx.upper_bound( boost::make_tuple( from_account.name, account_name_type() ) );
            itr != didx.end() && itr->from_account == from_account.name;
            ++itr )
       {
-         if( itr->auto_vest )
+         if( !itr->auto_vest )
          {
-            share_type to_deposit = ( ( fc::uint128_t ( to_withdraw.value ) * itr->percent ) / MORPHENE_100_PERCENT ).to_uint64();
-            vests_deposited_as_vests += to_deposit;
+            liquid_routes.push_back( &(*itr) );
+            continue;
+         }
 
-            if( to_deposit > 0 )
-            {
-               const auto& to_account = get< account_object, by_name >( itr->to_account );
+         share_type to_deposit = ( ( fc::uint128_t ( to_withdraw.value ) * itr->percent ) / MORPHENE_100_PERCENT ).to_uint64();
+         vests_deposited_as_vests += to_deposit;
 
-               operation vop = fill_vesting_withdraw_operation( from_account.name, to_account.name, legacy_asset( to_deposit, VESTS_SYMBOL ), legacy_asset( to_deposit, VESTS_SYMBOL ) );
+         if( to_deposit > 0 )
+         {
+            const auto& to_account = get< account_object, by_name >( itr->to_account );
 
-               pre_push_virtual_operation( vop );
+            operation vop = fill_vesting_withdraw_operation( from_account.name, to_account.name, legacy_asset( to_deposit, VESTS_SYMBOL ), legacy_asset( to_deposit, VESTS_SYMBOL ) );
 
-               modify( to_account, [&]( account_object& a )
-               {
-                  a.vesting_shares.amount += to_deposit;
-               });
+            pre_push_virtual_operation( vop );
+
+            modify( to_account, [&]( account_object& a )
+            {
+               a.vesting_shares.amount += to_deposit;
+            });
 
-               adjust_proxied_witness_votes( to_account, to_deposit );
+            adjust_proxied_witness_votes( to_account, to_deposit );
 
-               post_push_virtual_operation( vop );
-            }
+            post_push_virtual_operation( vop );
          }
       }
 
-      for( auto itr = didx.upper_bound( boost::make_tuple( from_account.name, account_name_type() ) );
-           itr != didx.end() && itr->from_account == from_account.name;
-           ++itr )
+      for( const withdraw_vesting_route_object* route : liquid_routes )
       {
-         if( !itr->auto_vest )
+         share_type to_deposit = ( ( fc::uint128_t ( to_withdraw.value ) * route->percent ) / MORPHENE_100_PERCENT ).to_uint64();
+         vests_deposited_as_morphene += to_deposit;
+
+         if( to_deposit > 0 )
          {
-            const auto& to_account = get< account_object, by_name >( itr->to_account );
+            const auto& to_account = get< account_object, by_name >( route->to_account );
+            legacy_asset converted_morph = legacy_asset( to_deposit, VESTS_SYMBOL ) *
+               dynamic_global_property_object::vesting_share_price( total_vesting_fund_morph, total_vesting_shares );
 
-            share_type to_deposit = ( ( fc::uint128_t ( to_withdraw.value ) * itr->percent ) / MORPHENE_100_PERCENT ).to_uint64();
-            vests_deposited_as_morphene += to_deposit;
-            legacy_asset converted_morph = legacy_asset( to_deposit, VESTS_SYMBOL ) * cprops.get_vesting_share_price();
-            total_morph_converted += converted_morph;
+            operation vop = fill_vesting_withdraw_operation( from_account.name, to_account.name, legacy_asset( to_deposit, VESTS_SYMBOL), converted_morph );
 
-            if( to_deposit > 0 )
-            {
-               operation vop = fill_vesting_withdraw_operation( from_account.name, to_account.name, legacy_asset( to_deposit, VESTS_SYMBOL), converted_morph );
+            pre_push_virtual_operation( vop );
 
-               pre_push_virtual_operation( vop );
-
-               modify( to_account, [&]( account_object& a )
-               {
-                  a.balance += converted_morph;
-               });
+            modify( to_account, [&]( account_object& a )
+            {
+               a.balance += converted_morph;
+            });
 
-               modify( cprops, [&]( dynamic_global_property_object& o )
-               {
-                  o.total_vesting_fund_morph -= converted_morph;
-                  o.total_vesting_shares.amount -= to_deposit;
-               });
+            total_vesting_fund_morph -= converted_morph;
+            total_vesting_shares.amount -= to_deposit;
 
-               post_push_virtual_operation( vop );
-            }
+            post_push_virtual_operation( vop );
          }
       }
 
       share_type to_convert = to_withdraw - vests_deposited_as_morphene - vests_deposited_as_vests;
       FC_ASSERT( to_convert >= 0, "Deposited more vests than were supposed to be withdrawn" );
 
-      legacy_asset converted_morph = legacy_asset( to_convert, VESTS_SYMBOL ) * cprops.get_vesting_share_price();
+      legacy_asset converted_morph = legacy_asset( to_convert, VESTS_SYMBOL ) *
+         dynamic_global_property_object::vesting_share_price( total_vesting_fund_morph, total_vesting_shares );
       operation vop = fill_vesting_withdraw_operation( from_account.name, from_account.name, legacy_asset( to_convert, VESTS_SYMBOL ), converted_morph );
       pre_push_virtual_operation( vop );
 
@@ -1402,17 +1467,25 @@ void database::process_vesting_withdrawals()
          }
       });
 
-      modify( cprops, [&]( dynamic_global_property_object& o )
-      {
-         o.total_vesting_fund_morph -= converted_morph;
-         o.total_vesting_shares.amount -= to_convert;
-      });
+      total_vesting_fund_morph -= converted_morph;
+      total_vesting_shares.amount -= to_convert;
 
       if( to_withdraw > 0 )
          adjust_proxied_witness_votes( from_account, -to_withdraw );
 
       post_push_virtual_operation( vop );
    }
+
+   modify( cprops, [&]( dynamic_global_property_object& o )
+   {
+      o.total_vesting_fund_morph = total_vesting_fund_morph;
+      o.total_vesting_shares = total_vesting_shares;
+   });
+
+   apply_witness_vote_deltas();
+
+   if( _benchmark_dumper.is_enabled() )
+      _benchmark_dumper.add( "process_vesting_withdrawals", util::advanced_benchmark_dumper::now() - benchmark_start );
 }
 
 /**
@@ -1818,6 +1891,11 @@ void database::set_flush_interval( uint32_t flush_blocks )
 //////////////////// private methods ////////////////////
 
 void database::apply_block( const signed_block& next_block, uint32_t skip )
+{
+   apply_block( hashed_block( next_block ), skip );
+}
+
+void database::apply_block( const hashed_block& next_block, uint32_t skip )
 { try {
    //fc::time_point begin_time = fc::time_point::now();
 
@@ -1865,7 +1943,7 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
       }
    }
 
-} FC_CAPTURE_AND_RETHROW( (next_block) ) }
+} FC_CAPTURE_AND_RETHROW( (next_block.get()) ) }
 
 void database::check_free_memory( bool force_print, uint32_t current_block_num )
 {
@@ -1906,9 +1984,10 @@ void database::check_free_memory( bool force_print, uint32_t current_block_num )
    }
 }
 
-void database::_apply_block( const signed_block& next_block )
+void database::_apply_block( const hashed_block& block )
 { try {
-   block_notification note( next_block );
+   const signed_block& next_block = block.get();
+   block_notification note( next_block, block.id() );
 
    notify_pre_apply_block( note );
 
@@ -1965,11 +2044,11 @@ void database::_apply_block( const signed_block& next_block )
 
    if( !( skip & skip_merkle_check ) )
    {
-      auto merkle_root = next_block.calculate_merkle_root();
+      const auto& merkle_root = block.merkle_root();
 
       try
       {
-         FC_ASSERT( next_block.transaction_merkle_root == merkle_root, "Merkle check failed", ("next_block.transaction_merkle_root",next_block.transaction_merkle_root)("calc",merkle_root)("next_block",next_block)("id",next_block.id()) );
+         FC_ASSERT( next_block.transaction_merkle_root == merkle_root, "Merkle check failed", ("next_block.transaction_merkle_root",next_block.transaction_merkle_root)("calc",merkle_root)("next_block",next_block)("id",block.id()) );
       }
       catch( fc::assert_exception& e )
       {
@@ -1981,7 +2060,7 @@ void database::_apply_block( const signed_block& next_block )
       }
    }
 
-   const witness_object& signing_witness = validate_block_header(skip, next_block);
+   const witness_object& signing_witness = validate_block_header(skip, block);
 
    const auto& gprops = get_dynamic_global_properties();
    auto block_size = fc::raw::pack_size( next_block );
@@ -2010,7 +2089,7 @@ void database::_apply_block( const signed_block& next_block )
       ("witness",witness)("next_block.witness",next_block.witness)("hardfork_state", hardfork_state)
    );
 
-   for( const auto& trx : next_block.transactions )
+   for( const auto& trx : block.transactions() )
    {
       /* We do not need to push the undo state for each transaction
        * because they either all apply and are valid or the
@@ -2031,7 +2110,7 @@ void database::_apply_block( const signed_block& next_block )
 
    update_last_irreversible_block();
 
-   create_block_summary(next_block);
+   create_block_summary(block);
    clear_expired_transactions();
    clear_expired_delegations();
    update_witness_schedule(*this);
@@ -2055,7 +2134,7 @@ void database::_apply_block( const signed_block& next_block )
    // last call of applying a block because it is the only thing that is not
    // reversible.
    migrate_irreversible_state();
-} FC_CAPTURE_LOG_AND_RETHROW( (next_block.block_num()) ) }
+} FC_CAPTURE_LOG_AND_RETHROW( (block.block_num()) ) }
 
 struct process_header_visitor
 {
@@ -2108,13 +2187,24 @@ void database::process_header_extensions( const signed_block& next_block )
 }
 
 void database::apply_transaction(const signed_transaction& trx, uint32_t skip)
+{
+   apply_transaction( hashed_transaction( trx ), skip );
+}
+
+void database::apply_transaction(const hashed_transaction& trx, uint32_t skip)
 {
    detail::with_skip_flags( *this, skip, [&]() { _apply_transaction(trx); });
 }
 
 void database::_apply_transaction(const signed_transaction& trx)
+{
+   _apply_transaction( hashed_transaction( trx ) );
+}
+
+void database::_apply_transaction(const hashed_transaction& htrx)
 { try {
-   transaction_notification note(trx);
+   const signed_transaction& trx = htrx.get();
+   transaction_notification note(trx, htrx.id());
    _current_trx_id = note.transaction_id;
    const transaction_id_type& trx_id = note.transaction_id;
    _current_virtual_op = 0;
@@ -2195,20 +2285,28 @@ void database::_apply_transaction(const signed_transaction& trx)
 
    notify_post_apply_transaction( note );
 
-} FC_CAPTURE_AND_RETHROW( (trx) ) }
+} FC_CAPTURE_AND_RETHROW( (htrx.get()) ) }
 
 void database::apply_operation(const operation& op)
 {
    operation_notification note = create_operation_notification( op );
    notify_pre_apply_operation( note );
 
+   size_t free_memory_before = 0;
    if( _benchmark_dumper.is_enabled() )
+   {
+      free_memory_before = get_free_memory();
       _benchmark_dumper.begin();
+   }
 
    _my->_evaluator_registry.get_evaluator( op ).apply( op );
 
    if( _benchmark_dumper.is_enabled() )
-      _benchmark_dumper.end< true/*APPLY_CONTEXT*/ >( _my->_evaluator_registry.get_evaluator( op ).get_name( op ) );
+   {
+      // State growth is approximated by the shared memory consumed by the evaluator
+      int64_t state_bytes = int64_t( free_memory_before ) - int64_t( get_free_memory() );
+      _benchmark_dumper.end< true/*APPLY_CONTEXT*/ >( _my->_evaluator_registry.get_evaluator( op ).get_name( op ), state_bytes );
+   }
 
    notify_post_apply_operation( note );
 }
@@ -2347,15 +2445,16 @@ boost::signals2::connection database::add_post_reindex_handler(const reindex_han
    return connect_impl(_post_reindex_signal, func, plugin, group, "<-reindex");
 }
 
-const witness_object& database::validate_block_header( uint32_t skip, const signed_block& next_block )const
+const witness_object& database::validate_block_header( uint32_t skip, const hashed_block& block )const
 { try {
+   const signed_block& next_block = block.get();
    FC_ASSERT( head_block_id() == next_block.previous, "", ("head_block_id",head_block_id())("next.prev",next_block.previous) );
    FC_ASSERT( head_block_time() < next_block.timestamp, "", ("head_block_time",head_block_time())("next",next_block.timestamp)("blocknum",next_block.block_num()) );
    const witness_object& witness = get_witness( next_block.witness );
 
    if( !(skip&skip_witness_signature) )
-      FC_ASSERT( next_block.validate_signee( witness.signing_key,
-         fc::ecc::bip_0062 ) );
+      FC_ASSERT( public_key_type( fc::ecc::public_key( next_block.witness_signature, block.digest(),
+         fc::ecc::bip_0062 ) ) == witness.signing_key );
 
    if( !(skip&skip_witness_schedule_check) )
    {
@@ -2371,7 +2470,7 @@ const witness_object& database::validate_block_header( uint32_t skip, const sign
    return witness;
 } FC_CAPTURE_AND_RETHROW() }
 
-void database::create_block_summary(const signed_block& next_block)
+void database::create_block_summary(const hashed_block& next_block)
 { try {
    block_summary_id_type sid( next_block.block_num() & 0xffff );
    modify( get< block_summary_object >( sid ), [&](block_summary_object& p) {
@@ -2524,7 +2623,7 @@ void database::migrate_irreversible_state()
 
             for( auto block_itr = blocks_to_write.begin(); block_itr != blocks_to_write.end(); ++block_itr )
             {
-               _block_log.append( block_itr->get()->data );
+               _block_log.append( block_itr->get()->data, block_itr->get()->id );
             }
 
             _block_log.flush();
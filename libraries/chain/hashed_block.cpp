@@ -0,0 +1,168 @@
+#include <morphene/chain/hashed_block.hpp>
+
+#include <fc/thread/work_stealing_pool.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace morphene { namespace chain {
+
+namespace detail {
+
+/**
+ * Waking a pool thread and waiting for its range costs about as much as hashing a few
+ * transactions or a few dozen digest pairs, so each extra thread is only given work when it
+ * has many times that much to do.
+ */
+static const size_t merkle_leaves_per_thread = 256;
+static const size_t merkle_pairs_per_thread = 1024;
+
+/**
+ * Threads kept for hashing, so a large block does not start and join new threads for every
+ * pass.  The calling thread takes a range as well, so the pool has one thread less than there
+ * are cores.  Never destroyed: its threads only ever wait for work, and tearing them down
+ * during static destruction would race with the fc thread state they use.
+ */
+static fc::work_stealing_pool& merkle_pool()
+{
+   static fc::work_stealing_pool* pool = new fc::work_stealing_pool(
+      std::max( 2u, std::thread::hardware_concurrency() ) - 1, "merkle" );
+   return *pool;
+}
+
+/**
+ * Calls f( begin, end ) over [0, n) in contiguous ranges, one per thread and at least
+ * min_per_thread long, using the calling thread for the first range and the merkle pool for
+ * the others.  Rethrows the first exception thrown by any range.
+ */
+template< typename Lambda >
+void parallel_for( size_t n, size_t min_per_thread, Lambda&& f )
+{
+   size_t num_threads = std::min< size_t >( n / min_per_thread, std::max( 1u, std::thread::hardware_concurrency() ) );
+   // Pool threads must not wait on the pool
+   if( num_threads <= 1 || merkle_pool().is_current() )
+   {
+      f( 0, n );
+      return;
+   }
+
+   size_t per_thread = ( n + num_threads - 1 ) / num_threads;
+   vector< std::exception_ptr > errors( num_threads );
+
+   // The ranges refer to this frame, so it waits for every one of them without a cancellable
+   // fc wait.  They are short CPU bound work.
+   std::mutex done_mutex;
+   std::condition_variable done_cond;
+   size_t remaining = num_threads - 1;
+
+   for( size_t t = 1; t < num_threads; ++t )
+   {
+      merkle_pool().async( [&, t]()
+      {
+         try { f( t * per_thread, std::min( n, ( t + 1 ) * per_thread ) ); }
+         catch( ... ) { errors[t] = std::current_exception(); }
+
+         std::lock_guard< std::mutex > lock( done_mutex );
+         if( --remaining == 0 )
+            done_cond.notify_one();
+      }, "merkle range" );
+   }
+
+   try { f( 0, per_thread ); }
+   catch( ... ) { errors[0] = std::current_exception(); }
+
+   {
+      std::unique_lock< std::mutex > lock( done_mutex );
+      done_cond.wait( lock, [&]() { return remaining == 0; } );
+   }
+
+   for( const auto& e : errors )
+      if( e )
+         std::rethrow_exception( e );
+}
+
+} // detail
+
+const transaction_id_type& hashed_transaction::id()const
+{
+   if( !_id )
+      _id = _trx->id();
+   return *_id;
+}
+
+const digest_type& hashed_transaction::merkle_digest()const
+{
+   if( !_merkle_digest )
+      _merkle_digest = _trx->merkle_digest();
+   return *_merkle_digest;
+}
+
+hashed_block::hashed_block( const signed_block& block ) : _block( &block )
+{
+   _transactions.reserve( block.transactions.size() );
+   for( const auto& trx : block.transactions )
+      _transactions.emplace_back( trx );
+}
+
+hashed_block::hashed_block( const signed_block& block, const block_id_type& id ) : hashed_block( block )
+{
+   _id = id;
+}
+
+const block_id_type& hashed_block::id()const
+{
+   if( !_id )
+      _id = _block->id();
+   return *_id;
+}
+
+const digest_type& hashed_block::digest()const
+{
+   if( !_digest )
+      _digest = _block->digest();
+   return *_digest;
+}
+
+const checksum_type& hashed_block::merkle_root()const
+{
+   if( !_merkle_root )
+      _merkle_root = merkle_root( _transactions );
+   return *_merkle_root;
+}
+
+checksum_type hashed_block::merkle_root( const vector< hashed_transaction >& transactions )
+{
+   // Leaves are independent, so they are hashed in parallel.  Any digests already cached
+   // are reused as is.
+   vector< digest_type > digests( transactions.size() );
+   detail::parallel_for( digests.size(), detail::merkle_leaves_per_thread, [&]( size_t begin, size_t end )
+   {
+      for( size_t i = begin; i < end; ++i )
+         digests[i] = transactions[i].merkle_digest();
+   } );
+
+   // Pairs within a level are independent too.  The levels are folded the same way
+   // signed_block::calculate_merkle_root does, which finishes off the small ones.
+   size_t count = digests.size();
+   while( count / 2 >= 2 * detail::merkle_pairs_per_thread )
+   {
+      size_t pairs = count / 2;
+      vector< digest_type > next( pairs + ( count & 1 ) );
+      detail::parallel_for( pairs, detail::merkle_pairs_per_thread, [&]( size_t begin, size_t end )
+      {
+         for( size_t i = begin; i < end; ++i )
+            next[i] = digest_type::hash( std::make_pair( digests[ 2 * i ], digests[ 2 * i + 1 ] ) );
+      } );
+      if( count & 1 )
+         next[ pairs ] = digests[ count - 1 ];
+      digests = std::move( next );
+      count = digests.size();
+   }
+
+   return signed_block::calculate_merkle_root( std::move( digests ) );
+}
+
+} } // morphene::chain
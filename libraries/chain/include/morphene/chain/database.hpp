@@ -4,6 +4,7 @@
 #pragma once
 #include <morphene/chain/block_log.hpp>
 #include <morphene/chain/fork_database.hpp>
+#include <morphene/chain/hashed_block.hpp>
 #include <morphene/chain/global_property_object.hpp>
 #include <morphene/chain/hardfork_property_object.hpp>
 #include <morphene/chain/node_property_object.hpp>
@@ -104,6 +105,7 @@ namespace morphene { namespace chain {
 
             // The following fields are only used on reindexing
             uint32_t stop_replay_at = 0;
+            uint32_t benchmark_start_at = 0;
             TBenchmark benchmark = TBenchmark(0, []( uint32_t, const abstract_index_cntr_t& ){});
          };
 
@@ -321,6 +323,13 @@ namespace morphene { namespace chain {
          /** this is called by `adjust_proxied_witness_votes` when account proxy to self */
          void adjust_witness_votes( const account_object& a, share_type delta );
 
+         /**
+          * While batching, `adjust_witness_votes` accumulates deltas per witness and
+          * `apply_witness_vote_deltas` applies each witness' net delta with a single modify.
+          */
+         void begin_witness_vote_batch();
+         void apply_witness_vote_deltas();
+
          /** this updates the vote of a single witness as a result of a vote being added or removed*/
          void adjust_witness_vote( const witness_object& obj, share_type delta );
 
@@ -382,6 +391,8 @@ namespace morphene { namespace chain {
 
          const std::string& get_json_schema() const;
 
+         const util::advanced_benchmark_dumper& get_benchmark_dumper()const { return _benchmark_dumper; }
+
          void set_flush_interval( uint32_t flush_blocks );
          void check_free_memory( bool force_print, uint32_t current_block_num );
 
@@ -398,18 +409,23 @@ namespace morphene { namespace chain {
       private:
          optional< chainbase::database::session > _pending_tx_session;
 
+         bool _push_block( const hashed_block& new_block );
+
          void apply_block( const signed_block& next_block, uint32_t skip = skip_nothing );
+         void apply_block( const hashed_block& next_block, uint32_t skip = skip_nothing );
          void apply_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
-         void _apply_block( const signed_block& next_block );
+         void apply_transaction( const hashed_transaction& trx, uint32_t skip = skip_nothing );
+         void _apply_block( const hashed_block& next_block );
          void _apply_transaction( const signed_transaction& trx );
+         void _apply_transaction( const hashed_transaction& trx );
          void apply_operation( const operation& op );
 
 
          ///Steps involved in applying a new block
          ///@{
 
-         const witness_object& validate_block_header( uint32_t skip, const signed_block& next_block )const;
-         void create_block_summary(const signed_block& next_block);
+         const witness_object& validate_block_header( uint32_t skip, const hashed_block& next_block )const;
+         void create_block_summary(const hashed_block& next_block);
 
          void clear_null_account_balance();
 
@@ -458,6 +474,8 @@ namespace morphene { namespace chain {
 
          optional< block_id_type >     _currently_processing_block_id;
 
+         optional< flat_map< account_name_type, share_type > >  _witness_vote_deltas;
+
          flat_map<uint32_t,block_id_type>  _checkpoints;
 
          node_property_object              _node_property_object;
@@ -55,10 +55,15 @@ namespace morphene { namespace chain {
 
          price       get_vesting_share_price() const
          {
-            if ( total_vesting_fund_morph.amount == 0 || total_vesting_shares.amount == 0 )
+            return vesting_share_price( total_vesting_fund_morph, total_vesting_shares );
+         }
+
+         static price vesting_share_price( const legacy_asset& vesting_fund_morph, const legacy_asset& vesting_shares )
+         {
+            if ( vesting_fund_morph.amount == 0 || vesting_shares.amount == 0 )
                return price ( legacy_asset( 1000, MORPH_SYMBOL ), legacy_asset( 1000000, VESTS_SYMBOL ) );
 
-            return price( total_vesting_shares, total_vesting_fund_morph );
+            return price( vesting_shares, vesting_fund_morph );
          }
 
          /**
@@ -0,0 +1,70 @@
+#pragma once
+#include <morphene/protocol/block.hpp>
+
+namespace morphene { namespace chain {
+
+   using morphene::protocol::block_id_type;
+   using morphene::protocol::checksum_type;
+   using morphene::protocol::digest_type;
+   using morphene::protocol::signed_block;
+   using morphene::protocol::signed_transaction;
+   using morphene::protocol::transaction_id_type;
+
+   /**
+    *  A read only view of a signed_transaction that computes each of its hashes at most once.
+    *
+    *  The transaction must not be modified or destroyed while the view is in use.
+    */
+   class hashed_transaction
+   {
+      public:
+         explicit hashed_transaction( const signed_transaction& trx ) : _trx( &trx ) {}
+
+         const signed_transaction&  get()const { return *_trx; }
+
+         const transaction_id_type& id()const;
+         const digest_type&         merkle_digest()const;
+
+      private:
+         const signed_transaction*                    _trx;
+         mutable fc::optional< transaction_id_type >  _id;
+         mutable fc::optional< digest_type >          _merkle_digest;
+   };
+
+   /**
+    *  A read only view of a signed_block that computes its id, header digest and merkle root
+    *  at most once, and does the same for each of its transactions.
+    *
+    *  For large blocks the merkle root is computed on several threads.  Transaction digests
+    *  are stored in the transaction views as a side effect.
+    *
+    *  The block must not be modified or destroyed while the view is in use.
+    */
+   class hashed_block
+   {
+      public:
+         explicit hashed_block( const signed_block& block );
+         /// For blocks whose id is already trusted, such as those in the fork database
+         hashed_block( const signed_block& block, const block_id_type& id );
+
+         const signed_block&  get()const { return *_block; }
+         uint32_t             block_num()const { return _block->block_num(); }
+
+         const block_id_type& id()const;
+         const digest_type&   digest()const;
+         const checksum_type& merkle_root()const;
+
+         const vector< hashed_transaction >& transactions()const { return _transactions; }
+
+         /// Computes the merkle root of transactions, reusing any digests they have cached
+         static checksum_type merkle_root( const vector< hashed_transaction >& transactions );
+
+      private:
+         const signed_block*                    _block;
+         vector< hashed_transaction >           _transactions;
+         mutable fc::optional< block_id_type >  _id;
+         mutable fc::optional< digest_type >    _digest;
+         mutable fc::optional< checksum_type >  _merkle_root;
+   };
+
+} } // morphene::chain
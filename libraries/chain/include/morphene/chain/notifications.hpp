@@ -6,9 +6,10 @@ namespace morphene { namespace chain {
 
 struct block_notification
 {
-   block_notification( const morphene::protocol::signed_block& b ) : block(b)
+   block_notification( const morphene::protocol::signed_block& b ) : block_notification( b, b.id() ) {}
+
+   block_notification( const morphene::protocol::signed_block& b, const morphene::protocol::block_id_type& id ) : block_id(id), block(b)
    {
-      block_id = b.id();
       block_num = block_header::num_from_id( block_id );
    }
 
@@ -19,10 +20,10 @@ struct block_notification
 
 struct transaction_notification
 {
-   transaction_notification( const morphene::protocol::signed_transaction& tx ) : transaction(tx)
-   {
-      transaction_id = tx.id();
-   }
+   transaction_notification( const morphene::protocol::signed_transaction& tx ) : transaction_notification( tx, tx.id() ) {}
+
+   transaction_notification( const morphene::protocol::signed_transaction& tx, const morphene::protocol::transaction_id_type& id )
+      : transaction_id(id), transaction(tx) {}
 
    morphene::protocol::transaction_id_type          transaction_id;
    const morphene::protocol::signed_transaction&    transaction;
@@ -27,11 +27,21 @@ class advanced_benchmark_dumper
       {
          std::string op_name;
          mutable uint64_t time;
+         mutable uint64_t count = 1;
+         mutable double time_squared = 0;
+         mutable int64_t state_bytes = 0;
 
-         item( std::string _op_name, uint64_t _time ): op_name( _op_name ), time( _time ) {}
+         item( std::string _op_name, uint64_t _time, int64_t _state_bytes = 0 ):
+            op_name( _op_name ), time( _time ), time_squared( double( _time ) * double( _time ) ), state_bytes( _state_bytes ) {}
 
          bool operator<( const item& obj ) const { return op_name < obj.op_name; }
-         void inc( uint64_t _time ) const { time += _time; }
+         void inc( uint64_t _time, int64_t _state_bytes = 0 ) const
+         {
+            time += _time;
+            time_squared += double( _time ) * double( _time );
+            state_bytes += _state_bytes;
+            ++count;
+         }
       };
 
       struct ritem
@@ -100,16 +110,27 @@ class advanced_benchmark_dumper
       void set_enabled( bool val ) { enabled = val; }
       bool is_enabled() { return enabled; }
 
+      const total_info< std::set< item > >& get_info()const { return info; }
+
+      /// Times are measured in nanoseconds
       void begin();
       template< bool APPLY_CONTEXT = false >
-      void end( const std::string& str );
+      void end( const std::string& str, int64_t state_bytes = 0 );
+
+      /**
+       * begin() and end() share one start time, so they cannot be nested. A region that calls
+       * code timed with them (plugin notifications, operation handlers) is timed by the caller
+       * from now() and recorded with add().
+       */
+      static uint64_t now();
+      void add( const std::string& str, uint64_t time, int64_t state_bytes = 0 );
 
       void dump();
 };
 
 } } } // morphene::chain::util
 
-FC_REFLECT( morphene::chain::util::advanced_benchmark_dumper::item, (op_name)(time) )
+FC_REFLECT( morphene::chain::util::advanced_benchmark_dumper::item, (op_name)(time)(count)(time_squared)(state_bytes) )
 FC_REFLECT( morphene::chain::util::advanced_benchmark_dumper::ritem, (op_name)(time) )
 
 FC_REFLECT( morphene::chain::util::advanced_benchmark_dumper::total_info< std::set< morphene::chain::util::advanced_benchmark_dumper::item > >, (total_time)(items) )
@@ -23,20 +23,31 @@ namespace morphene { namespace chain { namespace util {
       dump();
    }
 
+   uint64_t advanced_benchmark_dumper::now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+   }
+
    void advanced_benchmark_dumper::begin()
    {
-      time_begin = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+      time_begin = now();
    }
 
    template< bool APPLY_CONTEXT >
-   void advanced_benchmark_dumper::end( const std::string& str )
+   void advanced_benchmark_dumper::end( const std::string& str, int64_t state_bytes )
+   {
+      add( APPLY_CONTEXT ? (apply_context_name + str) : str, now() - time_begin, state_bytes );
+   }
+
+   template void advanced_benchmark_dumper::end< true >( const std::string& str, int64_t state_bytes );
+   template void advanced_benchmark_dumper::end< false >( const std::string& str, int64_t state_bytes );
+
+   void advanced_benchmark_dumper::add( const std::string& str, uint64_t time, int64_t state_bytes )
    {
-      uint64_t time = std::chrono::duration_cast<std::chrono::milliseconds>(
-         std::chrono::system_clock::now().time_since_epoch() ).count() - time_begin;
-      auto res = info.emplace( APPLY_CONTEXT ? (apply_context_name + str) : str, time );
+      auto res = info.emplace( str, time, state_bytes );
 
       if( !res.second )
-         res.first->inc( time );
+         res.first->inc( time, state_bytes );
 
       info.inc( time );
 
@@ -48,9 +59,6 @@ namespace morphene { namespace chain { namespace util {
       }
    }
 
-   template void advanced_benchmark_dumper::end< true >( const std::string& str );
-   template void advanced_benchmark_dumper::end< false >( const std::string& str );
-
    template< typename COLLECTION >
    void advanced_benchmark_dumper::dump_impl( const total_info< COLLECTION >& src, const std::string& src_file_name )
    {
@@ -44,40 +44,37 @@ void update_median_witness_props( database& db )
       active.push_back( &db.get_witness( wso.current_shuffled_witnesses[i] ) );
    }
 
-   /// sort them by account_creation_fee
-   std::sort( active.begin(), active.end(), [&]( const witness_object* a, const witness_object* b )
+   /// Only the median element is needed, so partially order the same scratch buffer for each property
+   auto median = [&]( auto less ) -> const witness_object*
+   {
+      std::nth_element( active.begin(), active.begin() + active.size()/2, active.end(), less );
+      return active[active.size()/2];
+   };
+
+   legacy_asset median_account_creation_fee = median( []( const witness_object* a, const witness_object* b )
    {
       return a->props.account_creation_fee.amount < b->props.account_creation_fee.amount;
-   } );
-   legacy_asset median_account_creation_fee = active[active.size()/2]->props.account_creation_fee;
+   } )->props.account_creation_fee;
 
-   /// sort them by maximum_block_size
-   std::sort( active.begin(), active.end(), [&]( const witness_object* a, const witness_object* b )
+   uint32_t median_maximum_block_size = median( []( const witness_object* a, const witness_object* b )
    {
       return a->props.maximum_block_size < b->props.maximum_block_size;
-   } );
-   uint32_t median_maximum_block_size = active[active.size()/2]->props.maximum_block_size;
+   } )->props.maximum_block_size;
 
-   /// sort them by account_subsidy_budget
-   std::sort( active.begin(), active.end(), [&]( const witness_object* a, const witness_object* b )
+   int32_t median_account_subsidy_budget = median( []( const witness_object* a, const witness_object* b )
    {
       return a->props.account_subsidy_budget < b->props.account_subsidy_budget;
-   } );
-   int32_t median_account_subsidy_budget = active[active.size()/2]->props.account_subsidy_budget;
+   } )->props.account_subsidy_budget;
 
-   /// sort them by account_subsidy_decay
-   std::sort( active.begin(), active.end(), [&]( const witness_object* a, const witness_object* b )
+   uint32_t median_account_subsidy_decay = median( []( const witness_object* a, const witness_object* b )
    {
       return a->props.account_subsidy_decay < b->props.account_subsidy_decay;
-   });
-   uint32_t median_account_subsidy_decay = active[active.size()/2]->props.account_subsidy_decay;
+   } )->props.account_subsidy_decay;
 
-   // sort them by pool level
-   std::sort( active.begin(), active.end(), [&]( const witness_object* a, const witness_object* b )
+   int64_t median_available_witness_account_subsidies = median( []( const witness_object* a, const witness_object* b )
    {
       return a->available_witness_account_subsidies < b->available_witness_account_subsidies;
-   });
-   int64_t median_available_witness_account_subsidies = active[active.size()/2]->available_witness_account_subsidies;
+   } )->available_witness_account_subsidies;
 
    rd_system_params account_subsidy_system_params;
    account_subsidy_system_params.resource_unit = MORPHENE_ACCOUNT_SUBSIDY_PRECISION;
@@ -141,7 +138,9 @@ void update_witness_schedule( database& db )
          continue;
       selected_voted.insert( itr->id );
       active_witnesses.push_back( itr->owner) ;
-      db.modify( *itr, [&]( witness_object& wo ) { wo.schedule = witness_object::elected; } );
+      // Witnesses that stay elected round after round are not touched
+      if( itr->schedule != witness_object::elected )
+         db.modify( *itr, [&]( witness_object& wo ) { wo.schedule = witness_object::elected; } );
    }
 
    auto num_elected = active_witnesses.size();
@@ -152,17 +151,20 @@ void update_witness_schedule( database& db )
    const auto& gprops = db.get_dynamic_global_properties();
    const auto& pow_idx = db.get_index<witness_index>().indices().get<by_pow>();
    auto mitr = pow_idx.upper_bound(0);
+   uint32_t num_processed_miners = 0;
    while( mitr != pow_idx.end() && selected_miners.size() < wso.max_miner_witnesses )
    {
+      bool selected = false;
+
       // Only consider a miner who is not a top voted witness
       if( selected_voted.find(mitr->id) == selected_voted.end() )
       {
          // Only consider a miner who has a valid block signing key
-         if( !( db.get_witness( mitr->owner ).signing_key == public_key_type() ) )
+         if( !( mitr->signing_key == public_key_type() ) )
          {
             selected_miners.insert(mitr->id);
             active_witnesses.push_back(mitr->owner);
-            db.modify( *mitr, [&]( witness_object& wo ) { wo.schedule = witness_object::miner; } );
+            selected = true;
          }
       }
       // Remove processed miner from the queue
@@ -170,11 +172,18 @@ void update_witness_schedule( database& db )
       ++mitr;
       db.modify( *itr, [&](witness_object& wit )
       {
+         if( selected )
+            wit.schedule = witness_object::miner;
          wit.pow_worker = 0;
       } );
+      ++num_processed_miners;
+   }
+
+   if( num_processed_miners > 0 )
+   {
       db.modify( gprops, [&]( dynamic_global_property_object& obj )
       {
-         obj.num_pow_witnesses--;
+         obj.num_pow_witnesses -= num_processed_miners;
       } );
    }
 
@@ -198,7 +207,8 @@ void update_witness_schedule( database& db )
       if( selected_voted.find(sitr->id) == selected_voted.end() )
       {
          active_witnesses.push_back(sitr->owner);
-         db.modify( *sitr, [&]( witness_object& wo ) { wo.schedule = witness_object::timeshare; } );
+         if( sitr->schedule != witness_object::timeshare )
+            db.modify( *sitr, [&]( witness_object& wo ) { wo.schedule = witness_object::timeshare; } );
          ++witness_count;
       }
    }
@@ -241,7 +251,7 @@ void update_witness_schedule( database& db )
 
    for( uint32_t i = 0; i < wso.num_scheduled_witnesses; i++ )
    {
-      auto witness = db.get_witness( wso.current_shuffled_witnesses[ i ] );
+      const auto& witness = db.get_witness( wso.current_shuffled_witnesses[ i ] );
       if( witness_versions.find( witness.running_version ) == witness_versions.end() )
          witness_versions[ witness.running_version ] = 1;
       else
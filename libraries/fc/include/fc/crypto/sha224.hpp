@@ -30,6 +30,9 @@ class sha224
       return e.result(); 
     } 
 
+    /// Number of hashes finished by any thread, only counted when built with FC_COUNT_HASHES
+    static uint64_t hash_count();
+
     class encoder 
     {
       public:
@@ -32,6 +32,9 @@ class sha256
       return e.result();
     }
 
+    /// Number of hashes finished by any thread, only counted when built with FC_COUNT_HASHES
+    static uint64_t hash_count();
+
     class encoder
     {
       public:
@@ -106,6 +109,8 @@ class sha256
 
   uint64_t hash64(const char* buf, size_t len);
 
+  namespace raw { template<> struct is_trivially_packable< sha256 > : std::true_type {}; }
+
 } // fc
 namespace std
 {
@@ -27,7 +27,7 @@ namespace fc { namespace json_relaxed
    fc::string tokenFromStream( T& in, uint32_t depth )
    {
       depth++;
-      fc::stringstream token;
+      fc::string token;
       try
       {
          char c = in.peek();
@@ -37,7 +37,7 @@ namespace fc { namespace json_relaxed
             switch( c = in.peek() )
             {
                case '\\':
-                  token << parseEscape( in, depth );
+                  token += parseEscape( in, depth );
                   break;
                case '\t':
                case ' ':
@@ -47,7 +47,7 @@ namespace fc { namespace json_relaxed
                case '\n':
                case '\x04':
                   in.get();
-                  return token.str();
+                  return token;
                case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h':
                case 'i': case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p':
                case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x':
@@ -59,33 +59,33 @@ namespace fc { namespace json_relaxed
                case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
                case '8': case '9':
                case '_': case '-': case '.': case '+': case '/':
-                  token << c;
+                  token += c;
                   in.get();
                   break;
                default:
-                  return token.str();
+                  return token;
             }
          }
-         return token.str();
+         return token;
       }
       catch( const fc::eof_exception& eof )
       {
-         return token.str();
+         return token;
       }
       catch (const std::ios_base::failure&)
       {
-         return token.str();
+         return token;
       }
 
       FC_RETHROW_EXCEPTIONS( warn, "while parsing token '${token}'",
-                                          ("token", token.str() ) );
+                                          ("token", token ) );
    }
 
    template<typename T, bool strict, bool allow_escape>
    fc::string quoteStringFromStream( T& in, uint32_t depth = 0 )
    {
        depth++;
-       fc::stringstream token;
+       fc::string token;
        try
        {
            char q = in.get();
@@ -130,23 +130,24 @@ namespace fc { namespace json_relaxed
                                if( c3 == q )
                                {
                                    in.get();
-                                   return token.str();
+                                   return token;
                                }
-                               token << q << q;
+                               token += q;
+                               token += q;
                                continue;
                            }
-                           token << q;
+                           token += q;
                            continue;
                        }
                        else if( c == '\x04' )
                            FC_THROW_EXCEPTION( parse_error_exception, "unexpected EOF in string '${token}'",
-                                      ("token", token.str() ) );
+                                      ("token", token ) );
                        else if( allow_escape && (c == '\\') )
-                           token << parseEscape( in, depth );
+                           token += parseEscape( in, depth );
                        else
                        {
                            in.get();
-                           token << c;
+                           token += c;
                        }
                    }
                }
@@ -154,30 +155,31 @@ namespace fc { namespace json_relaxed
            
            while( true )
            {
+               append_plain_run( in, token, q );
                char c = in.peek();
 
                if( c == q )
                {
                    in.get();
-                   return token.str();
+                   return token;
                }
                else if( c == '\x04' )
                    FC_THROW_EXCEPTION( parse_error_exception, "unexpected EOF in string '${token}'",
-                              ("token", token.str() ) );
+                              ("token", token ) );
                else if( allow_escape && (c == '\\') )
-                   token << parseEscape( in, depth );
+                   token += parseEscape( in, depth );
                else if( (c == '\r') | (c == '\n') )
                    FC_THROW_EXCEPTION( parse_error_exception, "unexpected EOL in string '${token}'",
-                              ("token", token.str() ) );
+                              ("token", token ) );
                else
                {
                    in.get();
-                   token << c;
+                   token += c;
                }
            }
            
        } FC_RETHROW_EXCEPTIONS( warn, "while parsing token '${token}'",
-                                          ("token", token.str() ) );
+                                          ("token", token ) );
    }
 
    template<typename T, bool strict>
@@ -533,15 +533,48 @@ namespace fc {
       }
     }
 
+    namespace detail {
+
+      template<typename Stream, typename T>
+      inline void pack_elements( Stream& s, const std::vector<T>& value, std::true_type ) {
+        if( value.size() )
+          s.write( (const char*)value.data(), value.size() * sizeof(T) );
+      }
+
+      template<typename Stream, typename T>
+      inline void pack_elements( Stream& s, const std::vector<T>& value, std::false_type ) {
+        auto itr = value.begin();
+        auto end = value.end();
+        while( itr != end ) {
+          fc::raw::pack( s, *itr );
+          ++itr;
+        }
+      }
+
+      template<typename Stream, typename T>
+      inline void unpack_elements( Stream& s, std::vector<T>& value, uint32_t size, uint32_t depth, std::true_type ) {
+        value.resize( size );
+        if( size )
+          s.read( (char*)value.data(), size * sizeof(T) );
+      }
+
+      template<typename Stream, typename T>
+      inline void unpack_elements( Stream& s, std::vector<T>& value, uint32_t size, uint32_t depth, std::false_type ) {
+        value.clear();
+        for ( size_t i = 0; i < size; i++ )
+        {
+           T tmp;
+           fc::raw::unpack( s, tmp, depth );
+           value.emplace_back( std::move( tmp ) );
+        }
+      }
+
+    } // namespace detail
+
     template<typename Stream, typename T>
     inline void pack( Stream& s, const std::vector<T>& value ) {
       fc::raw::pack( s, unsigned_int((uint32_t)value.size()) );
-      auto itr = value.begin();
-      auto end = value.end();
-      while( itr != end ) {
-        fc::raw::pack( s, *itr );
-        ++itr;
-      }
+      detail::pack_elements( s, value, typename is_trivially_packable<T>::type() );
     }
 
     template<typename Stream, typename T>
@@ -550,13 +583,7 @@ namespace fc {
       FC_ASSERT( depth <= MAX_RECURSION_DEPTH );
       unsigned_int size; fc::raw::unpack( s, size );
       FC_ASSERT( size.value*sizeof(T) < MAX_ARRAY_ALLOC_SIZE );
-      value.clear();
-      for ( size_t i = 0; i < size.value; i++ )
-      {
-         T tmp;
-         fc::raw::unpack( s, tmp, depth );
-         value.emplace_back( std::move( tmp ) );
-      }
+      detail::unpack_elements( s, value, size.value, depth, typename is_trivially_packable<T>::type() );
     }
 
     template<typename Stream, typename... T>
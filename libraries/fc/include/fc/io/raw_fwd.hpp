@@ -10,6 +10,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <set>
+#include <type_traits>
 
 #define MAX_ARRAY_ALLOC_SIZE (1024*1024*10) 
 #define MAX_RECURSION_DEPTH  (20)
@@ -33,6 +34,15 @@ namespace fc {
     template<typename T>
     inline size_t pack_size(  const T& v );
 
+    /**
+     *  True for types whose packed form is exactly their in-memory representation,
+     *  so that vectors of them can be packed and unpacked with a single copy.
+     */
+    template<typename T> struct is_trivially_packable
+       : std::integral_constant< bool, std::is_arithmetic<T>::value && !std::is_same<T,bool>::value > {};
+    template<typename T, size_t N> struct is_trivially_packable< fc::array<T,N> > : is_trivially_packable<T> {};
+    template<typename T, size_t N> struct is_trivially_packable< fc::int_array<T,N> > : is_trivially_packable<T> {};
+
     template<typename Stream, typename Storage> inline void pack( Stream& s, const fc::fixed_string<Storage>& u );
     template<typename Stream, typename Storage> inline void unpack( Stream& s, fc::fixed_string<Storage>& u, uint32_t depth = 0 );
 
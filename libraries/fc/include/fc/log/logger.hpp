@@ -9,6 +9,8 @@ namespace fc
 
    class appender;
 
+   namespace detail { class log_dispatcher; }
+
    /**
     *
     *
@@ -48,9 +50,22 @@ namespace fc
          void remove_appender( const fc::shared_ptr<appender>& a );
 
          bool is_enabled( log_level e )const;
+
+         /**
+          * Queues m for this logger's appenders.  Formatting and output happen on a background
+          * thread, so this never waits on an appender.
+          */
          void log( log_message m );
 
+         /** Number of messages discarded because the log queue was full. */
+         static uint64_t dropped_messages();
+
       private:
+         friend class detail::log_dispatcher;
+
+         /** Passes m to this logger's appenders, and to its parent's if additivity is set. */
+         void deliver( const log_message& m )const;
+
          class impl;
          fc::shared_ptr<impl> my;
    };
@@ -0,0 +1,83 @@
+#pragma once
+#include <fc/thread/task.hpp>
+
+#include <memory>
+#include <string>
+
+namespace fc {
+
+   namespace detail { class work_stealing_pool_impl; }
+
+   /**
+    *  @brief a fixed set of OS threads for CPU bound work.
+    *
+    *  An fc::thread runs all of its tasks on one OS thread, so expensive work posted to it
+    *  (deserializing, hashing) holds up everything else on that thread and never uses another
+    *  core.  A work_stealing_pool runs tasks to completion on its own threads instead.  Tasks
+    *  posted from outside the pool go on a shared queue and start in the order they were posted.
+    *  Tasks posted by a pool task go on that thread's own queue, newest first, and idle threads
+    *  steal the oldest task from a busy thread's queue.
+    *
+    *  async() returns an ordinary fc::future, so a task on an fc::thread can wait on the
+    *  result without blocking the other tasks of its thread.
+    *
+    *  Pool tasks run on plain OS threads rather than in fc contexts.  They should not yield,
+    *  sleep or wait on futures, which would block a pool thread.
+    */
+   class work_stealing_pool
+   {
+      public:
+         /**
+          *  @param num_threads the number of threads to start, 0 for one per core
+          *  @param name the name given to the threads
+          */
+         explicit work_stealing_pool( uint32_t num_threads = 0, const std::string& name = "pool" );
+
+         /// Calls quit()
+         ~work_stealing_pool();
+
+         work_stealing_pool( const work_stealing_pool& ) = delete;
+         work_stealing_pool& operator=( const work_stealing_pool& ) = delete;
+
+         /**
+          *  Calls <code>f</code> on one of the pool's threads and returns a future<T> that can
+          *  be used to wait on the result.
+          */
+         template<typename Functor>
+         auto async( Functor&& f, const char* desc FC_TASK_NAME_DEFAULT_ARG ) -> fc::future<decltype(f())> {
+            typedef decltype(f()) Result;
+            typedef typename fc::deduce<Functor>::type FunctorType;
+            fc::task<Result,sizeof(FunctorType)>* tsk =
+                 new fc::task<Result,sizeof(FunctorType)>( fc::forward<Functor>(f), desc );
+            fc::future<Result> r(fc::shared_ptr< fc::promise<Result> >(tsk,true) );
+            post_task(tsk);
+            return r;
+         }
+
+         /**
+          *  Stops the pool's threads after the tasks they are running finish.  Tasks that have
+          *  not started are canceled, causing their futures to throw canceled_exception.  Tasks
+          *  posted after quit() are canceled immediately.
+          */
+         void quit();
+
+         uint32_t size()const;
+
+         /// @return true if the calling thread is one of this pool's threads
+         bool is_current()const;
+
+      private:
+         void post_task( task_base* t );
+
+         std::unique_ptr< detail::work_stealing_pool_impl > my;
+   };
+
+   /**
+    *  Calls <code>f</code> in <code>pool</code>, see work_stealing_pool::async().
+    */
+   template<typename Functor>
+   auto async( work_stealing_pool& pool, Functor&& f, const char* desc FC_TASK_NAME_DEFAULT_ARG ) -> fc::future<decltype(f())> {
+      return pool.async( fc::forward<Functor>(f), desc );
+   }
+
+} // namespace fc
@@ -3,6 +3,7 @@
 #include <fc/fwd_impl.hpp>
 #include <openssl/sha.h>
 #include <string.h>
+#include <atomic>
 #include <fc/crypto/sha224.hpp>
 #include <fc/variant.hpp>
 #include "_digest_common.hpp"
@@ -26,6 +27,14 @@ namespace fc {
        SHA256_CTX ctx;
     };
 
+#ifdef FC_COUNT_HASHES
+    static std::atomic<uint64_t> sha224_hash_count( 0 );
+
+    uint64_t sha224::hash_count() { return sha224_hash_count.load( std::memory_order_relaxed ); }
+#else
+    uint64_t sha224::hash_count() { return 0; }
+#endif
+
     sha224::encoder::~encoder() {}
     sha224::encoder::encoder() {
       reset();
@@ -46,6 +55,9 @@ namespace fc {
     sha224 sha224::encoder::result() {
       sha224 h;
       SHA224_Final((uint8_t*)h.data(), &my->ctx );
+#ifdef FC_COUNT_HASHES
+      sha224_hash_count.fetch_add( 1, std::memory_order_relaxed );
+#endif
       return h;
     }
     void sha224::encoder::reset() {
@@ -3,6 +3,7 @@
 #include <fc/fwd_impl.hpp>
 #include <openssl/sha.h>
 #include <string.h>
+#include <atomic>
 #include <cmath>
 #include <fc/crypto/sha256.hpp>
 #include <fc/variant.hpp>
@@ -35,6 +36,14 @@ namespace fc {
        SHA256_CTX ctx;
     };
 
+#ifdef FC_COUNT_HASHES
+    static std::atomic<uint64_t> sha256_hash_count( 0 );
+
+    uint64_t sha256::hash_count() { return sha256_hash_count.load( std::memory_order_relaxed ); }
+#else
+    uint64_t sha256::hash_count() { return 0; }
+#endif
+
     sha256::encoder::~encoder() {}
     sha256::encoder::encoder() {
       reset();
@@ -61,6 +70,9 @@ namespace fc {
     sha256 sha256::encoder::result() {
       sha256 h;
       SHA256_Final((uint8_t*)h.data(), &my->ctx );
+#ifdef FC_COUNT_HASHES
+      sha256_hash_count.fetch_add( 1, std::memory_order_relaxed );
+#endif
       return h;
     }
     void sha256::encoder::reset() {
@@ -12,8 +12,170 @@
 
 #include <boost/filesystem/fstream.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace fc
 {
+   namespace detail
+   {
+      /**
+       * Reads a JSON document straight out of the caller's buffer.  peek() and get() behave like
+       * fc::stringstream's, throwing eof_exception once the buffer is exhausted, so the parsers
+       * below can be instantiated on it unchanged.
+       */
+      class json_buffer_stream
+      {
+         public:
+            json_buffer_stream( const char* begin, const char* end ) : _pos( begin ), _end( end ) {}
+
+            char peek()const
+            {
+               if( _pos == _end )
+                  FC_THROW_EXCEPTION( eof_exception, "json_buffer_stream" );
+               return *_pos;
+            }
+
+            char get()
+            {
+               if( _pos == _end )
+                  FC_THROW_EXCEPTION( eof_exception, "json_buffer_stream" );
+               return *_pos++;
+            }
+
+            /**
+             * Appends everything up to the next quote character q, backslash, ^D, CR or LF to
+             * token and leaves the stream positioned on that character.  The string parsers
+             * handle each of those one at a time, so the run in between is copied in one go.
+             */
+            void append_plain_run( fc::string& token, char q )
+            {
+               const char* p = _pos;
+#if defined(__SSE2__)
+               const __m128i quote = _mm_set1_epi8( q );
+               const __m128i backslash = _mm_set1_epi8( '\\' );
+               const __m128i eot = _mm_set1_epi8( '\x04' );
+               const __m128i cr = _mm_set1_epi8( '\r' );
+               const __m128i lf = _mm_set1_epi8( '\n' );
+               while( _end - p >= 16 )
+               {
+                  __m128i chunk = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ) );
+                  __m128i hits = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( chunk, quote ), _mm_cmpeq_epi8( chunk, backslash ) ),
+                                 _mm_or_si128( _mm_cmpeq_epi8( chunk, eot ),
+                                 _mm_or_si128( _mm_cmpeq_epi8( chunk, cr ), _mm_cmpeq_epi8( chunk, lf ) ) ) );
+                  int mask = _mm_movemask_epi8( hits );
+                  if( mask != 0 )
+                  {
+                     p += __builtin_ctz( mask );
+                     token.append( _pos, p );
+                     _pos = p;
+                     return;
+                  }
+                  p += 16;
+               }
+#endif
+               while( p != _end && *p != q && *p != '\\' && *p != '\x04' && *p != '\r' && *p != '\n' )
+                  ++p;
+               token.append( _pos, p );
+               _pos = p;
+            }
+
+         private:
+            const char* _pos;
+            const char* _end;
+      };
+   }
+
+   namespace detail
+   {
+      /**
+       * Appends JSON text straight into a string.  json::to_string writes through this instead
+       * of an fc::stringstream, so output doesn't go through fc::ostream or lexical_cast.
+       */
+      class json_string_writer
+      {
+         public:
+            explicit json_string_writer( fc::string& out ) : _out( out ) {}
+
+            json_string_writer& operator<<( char c )                 { _out += c; return *this; }
+            json_string_writer& operator<<( const char* s )          { _out += s; return *this; }
+            json_string_writer& operator<<( const fc::string& s )    { _out += s; return *this; }
+
+            json_string_writer& operator<<( uint64_t i )
+            {
+               char buf[20];
+               char* p = buf + sizeof(buf);
+               do
+               {
+                  *--p = char( '0' + i % 10 );
+                  i /= 10;
+               } while( i != 0 );
+               _out.append( p, buf + sizeof(buf) );
+               return *this;
+            }
+
+            json_string_writer& operator<<( int64_t i )
+            {
+               if( i < 0 )
+               {
+                  _out += '-';
+                  return *this << ( uint64_t( 0 ) - uint64_t( i ) );
+               }
+               return *this << uint64_t( i );
+            }
+
+            void append( const char* begin, const char* end ) { _out.append( begin, end ); }
+
+         private:
+            fc::string& _out;
+      };
+
+      /** A guess at the length of v's JSON text, used to reserve the output string up front. */
+      size_t estimated_json_size( const variant& v )
+      {
+         switch( v.get_type() )
+         {
+            case variant::null_type:
+               return 4;
+            case variant::int64_type:
+            case variant::uint64_type:
+            case variant::double_type:
+               return 12;
+            case variant::bool_type:
+               return 5;
+            case variant::string_type:
+               return v.get_string().size() + 2;
+            case variant::blob_type:
+               return v.get_blob().data.size() * 4 / 3 + 4;
+            case variant::array_type:
+            {
+               size_t size = 2;
+               for( const auto& item : v.get_array() )
+                  size += estimated_json_size( item ) + 1;
+               return size;
+            }
+            case variant::object_type:
+            {
+               size_t size = 2;
+               for( const auto& entry : v.get_object() )
+                  size += entry.key().size() + 4 + estimated_json_size( entry.value() );
+               return size;
+            }
+         }
+         return 0;
+      }
+   }
+
+   /** Streams without direct buffer access are read one character at a time. */
+   template<typename T>
+   inline void append_plain_run( T&, fc::string&, char ) {}
+
+   inline void append_plain_run( detail::json_buffer_stream& in, fc::string& token, char q )
+   {
+      in.append_plain_run( token, q );
+   }
+
     // forward declarations of provided functions
     template<typename T, json::parse_type parser_type> variant variant_from_stream( T& in, uint32_t depth = 0 );
     template<typename T> char parseEscape( T& in, uint32_t depth = 0 );
@@ -25,6 +187,7 @@ namespace fc
     template<typename T, json::parse_type parser_type> variant number_from_stream( T& in, uint32_t depth = 0 );
     template<typename T> variant token_from_stream( T& in, uint32_t depth = 0 );
     void escape_string( const string& str, ostream& os, uint32_t depth = 0 );
+    void escape_string( const string& str, detail::json_string_writer& os, uint32_t depth = 0 );
     template<typename T> void to_stream( T& os, const variants& a, json::output_formatting format );
     template<typename T> void to_stream( T& os, const variant_object& o, json::output_formatting format );
     template<typename T> void to_stream( T& os, const variant& v, json::output_formatting format );
@@ -88,7 +251,7 @@ namespace fc
    template<typename T>
    fc::string stringFromStream( T& in, uint32_t depth )
    {
-      fc::stringstream token;
+      fc::string token;
       try
       {
          char c = in.peek();
@@ -100,32 +263,32 @@ namespace fc
          in.get();
          while( true )
          {
-
+            append_plain_run( in, token, '"' );
             switch( c = in.peek() )
             {
                case '\\':
-                  token << parseEscape( in, depth );
+                  token += parseEscape( in, depth );
                   break;
                case 0x04:
                   FC_THROW_EXCEPTION( parse_error_exception, "EOF before closing '\"' in string '${token}'",
-                                                   ("token", token.str() ) );
+                                                   ("token", token ) );
                case '"':
                   in.get();
-                  return token.str();
+                  return token;
                default:
-                  token << c;
+                  token += c;
                   in.get();
             }
          }
          FC_THROW_EXCEPTION( parse_error_exception, "EOF before closing '\"' in string '${token}'",
-                                          ("token", token.str() ) );
+                                          ("token", token ) );
        } FC_RETHROW_EXCEPTIONS( warn, "while parsing token '${token}'",
-                                          ("token", token.str() ) );
+                                          ("token", token ) );
    }
    template<typename T>
    fc::string stringFromToken( T& in, uint32_t depth )
    {
-      fc::stringstream token;
+      fc::string token;
       try
       {
          char c = in.peek();
@@ -135,36 +298,36 @@ namespace fc
             switch( c = in.peek() )
             {
                case '\\':
-                  token << parseEscape( in, depth );
+                  token += parseEscape( in, depth );
                   break;
                case '\t':
                case ' ':
                case '\0':
                case '\n':
                   in.get();
-                  return token.str();
+                  return token;
                default:
                 if( isalnum( c ) || c == '_' || c == '-' || c == '.' || c == ':' || c == '/' )
                 {
-                  token << c;
+                  token += c;
                   in.get();
                 }
-                else return token.str();
+                else return token;
             }
          }
-         return token.str();
+         return token;
       }
       catch( const fc::eof_exception& eof )
       {
-         return token.str();
+         return token;
       }
       catch (const std::ios_base::failure&)
       {
-         return token.str();
+         return token;
       }
 
       FC_RETHROW_EXCEPTIONS( warn, "while parsing token '${token}'",
-                                          ("token", token.str() ) );
+                                          ("token", token ) );
    }
 
    template<typename T, json::parse_type parser_type>
@@ -258,14 +421,14 @@ namespace fc
    variant number_from_stream( T& in, uint32_t depth )
    {
       depth++;
-      fc::stringstream ss;
+      fc::string str;
 
       bool  dot = false;
       bool  neg = false;
       if( in.peek() == '-')
       {
         neg = true;
-        ss.put( in.get() );
+        str += in.get();
       }
       bool done = false;
 
@@ -291,12 +454,12 @@ namespace fc
               case '7':
               case '8':
               case '9':
-                 ss.put( in.get() );
+                 str += in.get();
                  break;
               default:
                  if( isalnum( c ) )
                  {
-                    return ss.str() + stringFromToken( in, depth );
+                    return str + stringFromToken( in, depth );
                  }
                 done = true;
                 break;
@@ -309,7 +472,6 @@ namespace fc
       catch (const std::ios_base::failure&)
       {
       }
-      fc::string str = ss.str();
       if (str == "-." || str == ".") // check the obviously wrong things we could have encountered
         FC_THROW_EXCEPTION(parse_error_exception, "Can't parse token \"${token}\" as a JSON numeric constant", ("token", str));
       if( dot )
@@ -322,8 +484,7 @@ namespace fc
    variant token_from_stream( T& in, uint32_t depth )
    {
       depth++;
-      std::stringstream ss;
-      ss.exceptions( std::ifstream::badbit );
+      fc::string str;
       bool received_eof = false;
       bool done = false;
 
@@ -343,7 +504,7 @@ namespace fc
               case 'f':
               case 'a':
               case 's':
-                 ss.put( in.get() );
+                 str += in.get();
                  break;
               default:
                  done = true;
@@ -362,7 +523,6 @@ namespace fc
 
       // we can get here either by processing a delimiter as in "null,"
       // an EOF like "null<EOF>", or an invalid token like "nullZ"
-      fc::string str = ss.str();
       if( str == "null" )
         return variant();
       if( str == "true" )
@@ -471,18 +631,17 @@ namespace fc
       FC_ASSERT( depth <= JSON_MAX_RECURSION_DEPTH );
       check_string_depth( utf8_str );
 
-      fc::stringstream in( utf8_str );
-      //in.exceptions( std::ifstream::eofbit );
+      detail::json_buffer_stream in( utf8_str.data(), utf8_str.data() + utf8_str.size() );
       switch( ptype )
       {
           case legacy_parser:
-              return variant_from_stream<fc::stringstream, legacy_parser>( in, depth );
+              return variant_from_stream<detail::json_buffer_stream, legacy_parser>( in, depth );
           case legacy_parser_with_string_doubles:
-              return variant_from_stream<fc::stringstream, legacy_parser_with_string_doubles>( in, depth );
+              return variant_from_stream<detail::json_buffer_stream, legacy_parser_with_string_doubles>( in, depth );
           case strict_parser:
-              return json_relaxed::variant_from_stream<fc::stringstream, true>( in, depth );
+              return json_relaxed::variant_from_stream<detail::json_buffer_stream, true>( in, depth );
           case relaxed_parser:
-              return json_relaxed::variant_from_stream<fc::stringstream, false>( in, depth );
+              return json_relaxed::variant_from_stream<detail::json_buffer_stream, false>( in, depth );
           default:
               FC_ASSERT( false, "Unknown JSON parser type {ptype}", ("ptype", ptype) );
       }
@@ -494,13 +653,11 @@ namespace fc
       FC_ASSERT( depth <= JSON_MAX_RECURSION_DEPTH );
       check_string_depth( utf8_str );
       variants result;
-      fc::stringstream in( utf8_str );
-      //in.exceptions( std::ifstream::eofbit );
+      detail::json_buffer_stream in( utf8_str.data(), utf8_str.data() + utf8_str.size() );
       try {
          while( true )
          {
-           // result.push_back( variant_from_stream( in ));
-           result.push_back(json_relaxed::variant_from_stream<fc::stringstream, false>( in, depth ));
+           result.push_back(json_relaxed::variant_from_stream<detail::json_buffer_stream, false>( in, depth ));
          }
       } catch ( const fc::eof_exception& ){}
       return result;
@@ -592,6 +749,61 @@ namespace fc
       }
       os << '"';
    }
+   /**
+    *  Same output as escape_string above.  Runs of characters that need no escaping are found
+    *  16 bytes at a time where SSE2 is available and appended in one go.
+    */
+   void escape_string( const string& str, detail::json_string_writer& os, uint32_t )
+   {
+      static const char* const control_escapes[0x20] = {
+         "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+         "\\b",     "\\t",     "\\n",     "\\u000b", "\\f",     "\\r",     "\\u000e", "\\u000f",
+         "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+         "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f"
+      };
+
+      os << '"';
+      const char* p = str.data();
+      const char* end = p + str.size();
+      const char* run = p;
+      while( true )
+      {
+#if defined(__SSE2__)
+         const __m128i quote = _mm_set1_epi8( '"' );
+         const __m128i backslash = _mm_set1_epi8( '\\' );
+         const __m128i max_control = _mm_set1_epi8( 0x1f );
+         while( end - p >= 16 )
+         {
+            __m128i chunk = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ) );
+            __m128i hits = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( chunk, quote ), _mm_cmpeq_epi8( chunk, backslash ) ),
+                                         _mm_cmpeq_epi8( _mm_max_epu8( chunk, max_control ), max_control ) );
+            int mask = _mm_movemask_epi8( hits );
+            if( mask != 0 )
+            {
+               p += __builtin_ctz( mask );
+               break;
+            }
+            p += 16;
+         }
+#endif
+         while( p != end && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20 )
+            ++p;
+
+         os.append( run, p );
+         if( p == end )
+            break;
+
+         if( *p == '"' )
+            os << "\\\"";
+         else if( *p == '\\' )
+            os << "\\\\";
+         else
+            os << control_escapes[ (unsigned char)*p ];
+         run = ++p;
+      }
+      os << '"';
+   }
+
    ostream& json::to_stream( ostream& out, const fc::string& str )
    {
         escape_string( str, out );
@@ -644,7 +856,7 @@ namespace fc
               int64_t i = v.as_int64();
               if( format == json::stringify_large_ints_and_doubles &&
                   i > 0xffffffff )
-                 os << '"'<<v.as_string()<<'"';
+                 os << '"'<<i<<'"';
               else
                  os << i;
 
@@ -655,7 +867,7 @@ namespace fc
               uint64_t i = v.as_uint64();
               if( format == json::stringify_large_ints_and_doubles &&
                   i > 0xffffffff )
-                 os << '"'<<v.as_string()<<'"';
+                 os << '"'<<i<<'"';
               else
                  os << i;
 
@@ -693,9 +905,11 @@ namespace fc
 
    fc::string   json::to_string( const variant& v, output_formatting format /* = stringify_large_ints_and_doubles */ )
    {
-      fc::stringstream ss;
-      fc::to_stream( ss, v, format );
-      return ss.str();
+      fc::string result;
+      result.reserve( detail::estimated_json_size( v ) );
+      detail::json_string_writer out( result );
+      fc::to_stream( out, v, format );
+      return result;
    }
 
 
@@ -866,20 +1080,20 @@ namespace fc
    bool json::is_valid( const std::string& utf8_str, parse_type ptype, uint32_t depth )
    {
       if( utf8_str.size() == 0 ) return false;
-      fc::stringstream in( utf8_str );
+      detail::json_buffer_stream in( utf8_str.data(), utf8_str.data() + utf8_str.size() );
       switch( ptype )
       {
           case legacy_parser:
-              variant_from_stream<fc::stringstream, legacy_parser>( in, depth );
+              variant_from_stream<detail::json_buffer_stream, legacy_parser>( in, depth );
               break;
           case legacy_parser_with_string_doubles:
-              variant_from_stream<fc::stringstream, legacy_parser_with_string_doubles>( in, depth );
+              variant_from_stream<detail::json_buffer_stream, legacy_parser_with_string_doubles>( in, depth );
               break;
           case strict_parser:
-              json_relaxed::variant_from_stream<fc::stringstream, true>( in, depth );
+              json_relaxed::variant_from_stream<detail::json_buffer_stream, true>( in, depth );
               break;
           case relaxed_parser:
-              json_relaxed::variant_from_stream<fc::stringstream, false>( in, depth );
+              json_relaxed::variant_from_stream<detail::json_buffer_stream, false>( in, depth );
               break;
           default:
               FC_ASSERT( false, "Unknown JSON parser type {ptype}", ("ptype", ptype) );
@@ -84,7 +84,8 @@ namespace fc {
    }
 
    boost::mutex& log_mutex() {
-    static boost::mutex m; return m;
+    // Never destroyed: the log queue is still drained by an atexit handler during static destruction
+    static boost::mutex* m = new boost::mutex; return *m;
    }
 
    void console_appender::log( const log_message& m ) {
@@ -9,8 +9,211 @@
 #include <string>
 #include <fc/log/logger_config.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace fc {
 
+    namespace detail
+    {
+       /**
+        * Carries log messages from the threads that emit them to one background thread, where the
+        * appenders format and write them.  The queue is a fixed ring of slots, each with a sequence
+        * number saying whether it is free for the next producer or ready for the consumer, so a
+        * push never takes a lock or waits.  When the ring is full the message is dropped and
+        * counted, and the count is logged once there is room again.
+        */
+       class log_dispatcher
+       {
+          public:
+             static log_dispatcher& instance()
+             {
+                // Never destroyed: messages may still be logged while other statics are torn down
+                static log_dispatcher* d = new log_dispatcher();
+                return *d;
+             }
+
+             void push( const logger& target, const log_message& m )
+             {
+                if( _stopped.load() )
+                {
+                   target.deliver( m );
+                   return;
+                }
+
+                size_t pos = _push_pos.load( std::memory_order_relaxed );
+                slot* s;
+                while( true )
+                {
+                   s = &_slots[ pos % capacity ];
+                   size_t seq = s->sequence.load( std::memory_order_acquire );
+                   if( seq == pos )
+                   {
+                      if( _push_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                         break;
+                   }
+                   else if( seq < pos )
+                   {
+                      _dropped.fetch_add( 1, std::memory_order_relaxed );
+                      return;
+                   }
+                   else
+                      pos = _push_pos.load( std::memory_order_relaxed );
+                }
+
+                s->target = target;
+                s->message = m;
+                s->sequence.store( pos + 1, std::memory_order_release );
+
+                if( _consumer_waiting.load() )
+                {
+                   std::lock_guard< std::mutex > lock( _wait_mutex );
+                   _wait_cond.notify_one();
+                }
+             }
+
+             uint64_t dropped()const { return _dropped.load( std::memory_order_relaxed ); }
+
+             /**
+              * Sets the logger that reports dropped messages.  configure_logging() replaces the
+              * loggers, and the background thread must not look them up while it does.
+              */
+             void set_dropped_logger( const logger& l )
+             {
+                std::lock_guard< std::mutex > lock( _dropped_logger_mutex );
+                _dropped_logger = l;
+             }
+
+             /** Delivers everything still queued and stops the background thread.  Later messages are delivered inline. */
+             void stop()
+             {
+                if( _stopping.exchange( true ) )
+                   return;
+                {
+                   std::lock_guard< std::mutex > lock( _wait_mutex );
+                   _wait_cond.notify_one();
+                }
+                if( _thread.joinable() )
+                   _thread.join();
+                _stopped.store( true );
+                // Anything pushed while the thread was exiting
+                drain();
+             }
+
+          private:
+             struct slot
+             {
+                std::atomic<size_t>        sequence;
+                fc::optional<logger>       target;
+                fc::optional<log_message>  message;
+             };
+
+             static const size_t capacity = 8192;
+
+             log_dispatcher()
+             :_slots( new slot[capacity] )
+             {
+                for( size_t i = 0; i < capacity; ++i )
+                   _slots[i].sequence.store( i, std::memory_order_relaxed );
+
+                try
+                {
+                   _thread = std::thread( [this]() { run(); } );
+                   std::atexit( []() { log_dispatcher::instance().stop(); } );
+                }
+                catch( ... )
+                {
+                   _stopping.store( true );
+                   _stopped.store( true );
+                }
+             }
+
+             bool pop_one()
+             {
+                slot& s = _slots[ _pop_pos % capacity ];
+                if( s.sequence.load( std::memory_order_acquire ) != _pop_pos + 1 )
+                   return false;
+
+                logger target = std::move( *s.target );
+                log_message m = std::move( *s.message );
+                s.target.reset();
+                s.message.reset();
+                s.sequence.store( _pop_pos + capacity, std::memory_order_release );
+                ++_pop_pos;
+
+                target.deliver( m );
+                return true;
+             }
+
+             void drain()
+             {
+                while( pop_one() ) {}
+                report_dropped();
+             }
+
+             void report_dropped()
+             {
+                uint64_t dropped = _dropped.load( std::memory_order_relaxed );
+                if( dropped == _reported_dropped )
+                   return;
+                logger target = nullptr;
+                {
+                   std::lock_guard< std::mutex > lock( _dropped_logger_mutex );
+                   target = _dropped_logger;
+                }
+                if( target != nullptr )
+                   target.deliver( FC_LOG_MESSAGE( warn, "Log queue was full, dropped ${n} log messages",
+                                                   ("n", dropped - _reported_dropped) ) );
+                _reported_dropped = dropped;
+             }
+
+             void run()
+             {
+                while( true )
+                {
+                   drain();
+
+                   std::unique_lock< std::mutex > lock( _wait_mutex );
+                   _consumer_waiting.store( true );
+                   if( _slots[ _pop_pos % capacity ].sequence.load() != _pop_pos + 1 )
+                   {
+                      if( _stopping.load() )
+                      {
+                         _consumer_waiting.store( false );
+                         return;
+                      }
+                      _wait_cond.wait_for( lock, std::chrono::milliseconds( 100 ) );
+                   }
+                   _consumer_waiting.store( false );
+                }
+             }
+
+             std::unique_ptr< slot[] > _slots;
+             std::atomic<size_t>       _push_pos{ 0 };
+             size_t                    _pop_pos = 0;
+             std::atomic<uint64_t>     _dropped{ 0 };
+             uint64_t                  _reported_dropped = 0;
+             std::atomic<bool>         _consumer_waiting{ false };
+             std::atomic<bool>         _stopping{ false };
+             std::atomic<bool>         _stopped{ false };
+             std::mutex                _wait_mutex;
+             std::condition_variable   _wait_cond;
+             std::thread               _thread;
+             std::mutex                _dropped_logger_mutex;
+             logger                    _dropped_logger = nullptr;
+       };
+
+       void set_dropped_messages_logger( const logger& l )
+       {
+          log_dispatcher::instance().set_dropped_logger( l );
+       }
+    }
+
     class logger::impl : public fc::retainable {
       public:
          impl()
@@ -21,7 +224,12 @@ namespace fc {
          bool             _additivity;
          log_level        _level;
 
-         std::vector<appender::ptr> _appenders;
+         /**
+          * Replaced, never modified, so the background thread can deliver from a snapshot while
+          * appenders are added.  Read with std::atomic_load, replaced under _appenders_lock.
+          */
+         std::shared_ptr< const std::vector<appender::ptr> > _appenders = std::make_shared< const std::vector<appender::ptr> >();
+         fc::spin_lock                                        _appenders_lock;
     };
 
 
@@ -63,14 +271,32 @@ namespace fc {
 
     void logger::log( log_message m ) {
        m.get_context().append_context( my->_name );
+       detail::log_dispatcher::instance().push( *this, m );
+    }
 
-       for( auto itr = my->_appenders.begin(); itr != my->_appenders.end(); ++itr )
-          (*itr)->log( m );
+    void logger::deliver( const log_message& m )const {
+       auto appenders = std::atomic_load( &my->_appenders );
+       for( auto itr = appenders->begin(); itr != appenders->end(); ++itr )
+       {
+          try
+          {
+             (*itr)->log( m );
+          }
+          catch( ... )
+          {
+             std::cerr << "exception thrown by log appender\n";
+          }
+       }
 
        if( my->_additivity && my->_parent != nullptr) {
-          my->_parent.log(m);
+          m.get_context().append_context( my->_parent.name() );
+          my->_parent.deliver( m );
        }
     }
+
+    uint64_t logger::dropped_messages() {
+       return detail::log_dispatcher::instance().dropped();
+    }
     void logger::set_name( const fc::string& n ) { my->_name = n; }
     const fc::string& logger::name()const { return my->_name; }
 
@@ -97,14 +323,19 @@ namespace fc {
     logger& logger::set_log_level(log_level ll) { my->_level = ll; return *this; }
 
     void logger::add_appender( const fc::shared_ptr<appender>& a )
-    { my->_appenders.push_back(a); }
+    {
+       scoped_lock<spin_lock> lock( my->_appenders_lock );
+       auto appenders = std::make_shared< std::vector<appender::ptr> >( *my->_appenders );
+       appenders->push_back( a );
+       std::atomic_store( &my->_appenders, std::shared_ptr< const std::vector<appender::ptr> >( std::move( appenders ) ) );
+    }
     
 //    void logger::remove_appender( const fc::shared_ptr<appender>& a )
  //   { my->_appenders.erase(a); }
 
     std::vector<fc::shared_ptr<appender> > logger::get_appenders()const
     {
-        return my->_appenders;
+        return *std::atomic_load( &my->_appenders );
     }
 
    bool configure_logging( const logging_config& cfg );
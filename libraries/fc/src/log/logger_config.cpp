@@ -13,6 +13,7 @@
 namespace fc {
    extern std::unordered_map<std::string,logger>& get_logger_map();
    extern std::unordered_map<std::string,appender::ptr>& get_appender_map();
+   namespace detail { void set_dropped_messages_logger( const logger& l ); }
    logger_config& logger_config::add_appender( const string& s ) { appenders.push_back(s); return *this; }
 
    void configure_logging( const fc::path& lc )
@@ -48,6 +49,8 @@ namespace fc {
             if( ap ) { lgr.add_appender(ap); }
          }
       }
+      // The log thread reports dropped messages here instead of looking the logger up itself
+      detail::set_dropped_messages_logger( logger::get( "default" ) );
       return reg_console_appender || reg_file_appender;
       } catch ( exception& e )
       {
@@ -0,0 +1,215 @@
+#include <fc/thread/work_stealing_pool.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fc {
+
+   namespace detail
+   {
+      class work_stealing_pool_impl
+      {
+         public:
+            struct worker_queue
+            {
+               std::mutex                mtx;
+               std::deque< task_base* >  tasks;
+            };
+
+            work_stealing_pool_impl( uint32_t num_threads, const std::string& name )
+            {
+               if( num_threads == 0 )
+                  num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+
+               for( uint32_t i = 0; i < num_threads; ++i )
+                  queues.emplace_back( new worker_queue() );
+
+               for( uint32_t i = 0; i < num_threads; ++i )
+               {
+                  std::string thread_name = name + "-" + std::to_string( i );
+                  threads.emplace_back( [this, i, thread_name]()
+                  {
+                     fc::thread::current().set_name( thread_name );
+                     run( i );
+                  } );
+               }
+            }
+
+            void post( task_base* t )
+            {
+               // Tasks posted by a pool thread stay on its queue, where that thread will most
+               // likely pick them up while their data is still in cache.  Everything else goes on
+               // the shared queue, which is served in the order tasks were posted.
+               worker_queue& queue = current_pool == this ? *queues[ current_index ] : shared;
+
+               {
+                  // Checked under wait_mutex so that nothing is queued after quit() has drained
+                  std::unique_lock< std::mutex > lock( wait_mutex );
+                  if( !stopping.load() )
+                  {
+                     {
+                        std::lock_guard< std::mutex > queue_lock( queue.mtx );
+                        queue.tasks.push_back( t );
+                     }
+                     ++pending;
+                     if( sleeping > 0 )
+                        wait_cond.notify_one();
+                     return;
+                  }
+               }
+
+               cancel_task( t );
+            }
+
+            void quit()
+            {
+               {
+                  std::lock_guard< std::mutex > lock( wait_mutex );
+                  if( stopping.exchange( true ) )
+                     return;
+                  wait_cond.notify_all();
+               }
+
+               for( auto& t : threads )
+                  t.join();
+
+               for( auto& q : queues )
+               {
+                  for( task_base* t : q->tasks )
+                     cancel_task( t );
+                  q->tasks.clear();
+               }
+               for( task_base* t : shared.tasks )
+                  cancel_task( t );
+               shared.tasks.clear();
+            }
+
+            static void cancel_task( task_base* t )
+            {
+               t->cancel( "work_stealing_pool quit" );
+               t->run();
+               t->release();
+            }
+
+            std::vector< std::unique_ptr< worker_queue > > queues;
+            worker_queue                                   shared;
+            std::vector< std::thread >                     threads;
+
+            std::mutex                                     wait_mutex;
+            std::condition_variable                        wait_cond;
+            std::atomic< size_t >                          pending{ 0 };  // raised under wait_mutex
+            uint32_t                                       sleeping = 0;  // guarded by wait_mutex
+            std::atomic< bool >                            stopping{ false };
+
+            static thread_local work_stealing_pool_impl*   current_pool;
+            static thread_local size_t                     current_index;
+
+         private:
+            /**
+             * Takes the newest task from this thread's own queue, then the oldest from the shared
+             * queue, then the oldest from another thread's queue.
+             */
+            task_base* next_task( size_t index )
+            {
+               {
+                  worker_queue& own = *queues[ index ];
+                  std::lock_guard< std::mutex > lock( own.mtx );
+                  if( !own.tasks.empty() )
+                  {
+                     task_base* t = own.tasks.back();
+                     own.tasks.pop_back();
+                     return t;
+                  }
+               }
+
+               {
+                  std::lock_guard< std::mutex > lock( shared.mtx );
+                  if( !shared.tasks.empty() )
+                  {
+                     task_base* t = shared.tasks.front();
+                     shared.tasks.pop_front();
+                     return t;
+                  }
+               }
+
+               for( size_t i = 1; i < queues.size(); ++i )
+               {
+                  worker_queue& victim = *queues[ ( index + i ) % queues.size() ];
+                  std::lock_guard< std::mutex > lock( victim.mtx );
+                  if( !victim.tasks.empty() )
+                  {
+                     task_base* t = victim.tasks.front();
+                     victim.tasks.pop_front();
+                     return t;
+                  }
+               }
+
+               return nullptr;
+            }
+
+            void run( size_t index )
+            {
+               current_pool = this;
+               current_index = index;
+
+               while( !stopping.load() )
+               {
+                  task_base* t = next_task( index );
+                  if( t == nullptr )
+                  {
+                     std::unique_lock< std::mutex > lock( wait_mutex );
+                     ++sleeping;
+                     wait_cond.wait( lock, [this]() { return pending > 0 || stopping.load(); } );
+                     --sleeping;
+                     continue;
+                  }
+
+                  --pending;
+                  t->run();
+                  t->release();
+               }
+
+               current_pool = nullptr;
+            }
+      };
+
+      thread_local work_stealing_pool_impl* work_stealing_pool_impl::current_pool = nullptr;
+      thread_local size_t work_stealing_pool_impl::current_index = 0;
+   }
+
+   work_stealing_pool::work_stealing_pool( uint32_t num_threads, const std::string& name )
+      : my( new detail::work_stealing_pool_impl( num_threads, name ) ) {}
+
+   work_stealing_pool::~work_stealing_pool()
+   {
+      quit();
+   }
+
+   void work_stealing_pool::quit()
+   {
+      FC_ASSERT( !is_current(), "work_stealing_pool cannot be stopped from one of its own threads" );
+      my->quit();
+   }
+
+   uint32_t work_stealing_pool::size()const
+   {
+      return my->threads.size();
+   }
+
+   bool work_stealing_pool::is_current()const
+   {
+      return detail::work_stealing_pool_impl::current_pool == my.get();
+   }
+
+   void work_stealing_pool::post_task( task_base* t )
+   {
+      my->post( t );
+   }
+
+} // namespace fc
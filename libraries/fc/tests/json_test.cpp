@@ -0,0 +1,237 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/io/buffered_iostream.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/sstream.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/variant_object.hpp>
+
+#include <limits>
+#include <memory>
+#include <random>
+
+using namespace fc;
+
+// json::to_string writes into a string directly; json::to_stream still goes through fc::ostream.
+// Both must produce exactly the same text.
+static void check_same_output( const variant& v )
+{
+   for( auto format : { json::stringify_large_ints_and_doubles, json::legacy_generator } )
+   {
+      fc::stringstream ss;
+      json::to_stream( ss, v, format );
+      BOOST_REQUIRE_EQUAL( json::to_string( v, format ), ss.str() );
+   }
+}
+
+static std::string random_string( std::mt19937& rng )
+{
+   static const char specials[] = { '"', '\\', '\0', '\x01', '\x04', '\b', '\t', '\n', '\f', '\r', '\x1f', '\x7f', '\x80', '\xff' };
+   std::string s( rng() % 80, ' ' );
+   for( auto& c : s )
+   {
+      if( rng() % 8 == 0 )
+         c = specials[ rng() % sizeof(specials) ];
+      else
+         c = char( ' ' + rng() % 95 );
+   }
+   return s;
+}
+
+// json::from_string and json::is_valid parse out of the string's buffer.  json::from_stream still
+// reads through an fc::istream one character at a time, which is how the strings used to be parsed.
+// Both must give the same value, or fail with the same exception.
+static const json::parse_type all_parse_types[] = {
+   json::legacy_parser, json::strict_parser, json::relaxed_parser, json::legacy_parser_with_string_doubles
+};
+
+template< typename Lambda >
+static std::string outcome( Lambda&& parse )
+{
+   try
+   {
+      return "ok " + parse();
+   }
+   catch( const fc::exception& e )
+   {
+      return "exception " + std::to_string( e.code() );
+   }
+}
+
+static std::string describe( const variant& v )
+{
+   return std::to_string( v.get_type() ) + " " + json::to_string( v );
+}
+
+static variant from_stream( const std::string& s, json::parse_type ptype, uint32_t depth = 0 )
+{
+   fc::buffered_istream in( std::make_shared< fc::stringstream >( s ) );
+   return json::from_stream( in, ptype, depth );
+}
+
+/** is_valid as it was, through a stream.  from_stream counts one more level than is_valid, so depth is one less. */
+static bool is_valid_from_stream( const std::string& s, json::parse_type ptype, uint32_t depth )
+{
+   if( s.empty() ) return false;
+   fc::buffered_istream in( std::make_shared< fc::stringstream >( s ) );
+   json::from_stream( in, ptype, depth );
+   try { in.peek(); } catch( const eof_exception& ) { return true; }
+   return false;
+}
+
+static void check_same_parse( const std::string& s, uint32_t depth = 1 )
+{
+   for( auto ptype : all_parse_types )
+   {
+      BOOST_REQUIRE_MESSAGE(
+         outcome( [&]() { return describe( json::from_string( s, ptype, depth - 1 ) ); } ) ==
+         outcome( [&]() { return describe( from_stream( s, ptype, depth - 1 ) ); } ),
+         "from_string differs for parser " << ptype << " on: " << s );
+      BOOST_REQUIRE_MESSAGE(
+         outcome( [&]() { return std::string( json::is_valid( s, ptype, depth ) ? "true" : "false" ); } ) ==
+         outcome( [&]() { return std::string( is_valid_from_stream( s, ptype, depth - 1 ) ? "true" : "false" ); } ),
+         "is_valid differs for parser " << ptype << " on: " << s );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(fc)
+
+BOOST_AUTO_TEST_CASE(json_from_string_matches_stream_parser)
+{
+   // Strings are scanned 16 bytes at a time, so every special character is tried at each offset
+   // around the first chunks, inside a string, unterminated, and followed by trailing garbage.
+   const std::string specials[] = {
+      "\\\"", "\\\\", "\\n", "\\r", "\\t", "\\/", "\\u0041", "\\u00e9", "\\x", "\\",
+      "\"", "'", "\r", "\n", "\r\n", "\t", "\x04", std::string( 1, '\0' ), "\x7f", "\xc3\xa9", "}", "]", ",", ":"
+   };
+   for( const std::string& special : specials )
+   {
+      for( size_t pos = 0; pos < 40; ++pos )
+      {
+         for( char quote : { '"', '\'' } )
+         {
+            std::string str = quote + std::string( pos, 'a' ) + special + std::string( 40 - pos, 'b' ) + quote;
+            check_same_parse( str );
+            check_same_parse( str.substr( 0, str.size() - 1 ) );
+            check_same_parse( str + "x" );
+            check_same_parse( str + "  \n" );
+            check_same_parse( "[" + str + ",1]" );
+            check_same_parse( "{" + str + ":" + str + "}" );
+            check_same_parse( "{\"key\":" + str + ",\"n\":-12.5e3}" );
+         }
+         check_same_parse( std::string( pos, ' ' ) + special );
+         check_same_parse( std::string( pos, 'a' ) + special + std::string( 40 - pos, 'b' ) );
+      }
+   }
+
+   const std::string others[] = {
+      "", " ", "\x04", "null", "true", "false", "nul", "tru", "0", "-0", "1.5", "-1.5e10", "1e", "0x10",
+      "12345678901234567890", "-12345678901234567890", "123456789012345678901234567890", "1.", ".5", "+1",
+      "[]", "{}", "[1,2,3]", "[1,,2]", "[1 2]", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "{'a':'b'}",
+      "{\"a\":1} x", "\"abc\"x", "1 2", "[1]]", "{}}", "\"a\"   ", "[1] \n", "abc def", "\"\"", "''"
+   };
+   for( const std::string& s : others )
+      check_same_parse( s );
+}
+
+BOOST_AUTO_TEST_CASE(json_from_string_depth_limits)
+{
+   // from_string rejects a hundred open brackets before parsing; below that both paths stop at the same depth
+   for( size_t n : { 1, 50, 98, 99, 100, 101 } )
+   {
+      for( const std::string& open_close : { std::string( "[]" ), std::string( "{}" ) } )
+      {
+         std::string s;
+         for( size_t i = 0; i < n; ++i )
+            s += open_close[0] == '{' ? "{\"a\":" : "[";
+         s += "1";
+         for( size_t i = 0; i < n; ++i )
+            s += open_close[1];
+
+         for( auto ptype : all_parse_types )
+         {
+            std::string expected = n < 100 ? outcome( [&]() { return describe( from_stream( s, ptype ) ); } )
+                                           : "exception " + std::to_string( fc::assert_exception_code );
+            BOOST_CHECK_EQUAL( outcome( [&]() { return describe( json::from_string( s, ptype ) ); } ), expected );
+         }
+
+         // a caller's depth counts toward the limit
+         for( uint32_t depth : std::initializer_list< uint32_t >{ 1, 100, 150, JSON_MAX_RECURSION_DEPTH - 50, JSON_MAX_RECURSION_DEPTH - 1, JSON_MAX_RECURSION_DEPTH } )
+            if( n < 100 )
+               check_same_parse( s, depth );
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(json_to_string_escapes_every_byte)
+{
+   for( int c = 0; c < 256; ++c )
+   {
+      std::string s( 1, char( c ) );
+      check_same_output( variant( s ) );
+      // put the character at every position of a vector sized chunk and just past it
+      for( size_t pos = 0; pos < 40; ++pos )
+      {
+         std::string padded( 40, 'a' );
+         padded[pos] = char( c );
+         check_same_output( variant( padded ) );
+      }
+   }
+   check_same_output( variant( std::string() ) );
+   check_same_output( variant( std::string( "\0\0\0", 3 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE(json_to_string_numbers)
+{
+   const int64_t signed_values[] = {
+      0, 1, -1, 9, 10, -10, 0xffffffffll, 0x100000000ll, -0x100000000ll,
+      std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()
+   };
+   for( int64_t i : signed_values )
+      check_same_output( variant( i ) );
+
+   const uint64_t unsigned_values[] = {
+      0, 1, 9, 10, 0xffffffffull, 0x100000000ull, std::numeric_limits<uint64_t>::max()
+   };
+   for( uint64_t i : unsigned_values )
+      check_same_output( variant( i ) );
+
+   std::mt19937 rng( 42 );
+   for( int n = 0; n < 10000; ++n )
+   {
+      uint64_t u = ( uint64_t( rng() ) << 32 ) | rng();
+      check_same_output( variant( u >> ( rng() % 64 ) ) );
+      check_same_output( variant( int64_t( u ) >> ( rng() % 64 ) ) );
+   }
+
+   check_same_output( variant( 0.0 ) );
+   check_same_output( variant( -1.5 ) );
+   check_same_output( variant( 3.14159265358979 ) );
+   check_same_output( variant( 1e300 ) );
+   check_same_output( variant( true ) );
+   check_same_output( variant( false ) );
+   check_same_output( variant() );
+   check_same_output( variant( blob{ std::vector<char>{ 'a', '\0', '"', '\xff' } } ) );
+}
+
+BOOST_AUTO_TEST_CASE(json_to_string_nested)
+{
+   std::mt19937 rng( 7 );
+   for( int n = 0; n < 200; ++n )
+   {
+      variants items;
+      for( int i = 0; i < 20; ++i )
+      {
+         mutable_variant_object obj;
+         obj( random_string( rng ), random_string( rng ) )
+            ( "amount", int64_t( rng() ) * ( rng() % 2 ? 1 : -1 ) * 100000 )
+            ( "count", uint64_t( rng() ) )
+            ( "empty", variants() )
+            ( "nested", mutable_variant_object( "list", variants{ variant( random_string( rng ) ), variant(), variant( true ) } ) );
+         items.push_back( variant( obj ) );
+      }
+      check_same_output( variant( items ) );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/log/appender.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/variant_object.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace fc;
+
+// Records the thread and sequence number of every message it is given.
+class counting_appender : public appender
+{
+   public:
+      counting_appender( size_t threads = 0, std::chrono::microseconds delay = std::chrono::microseconds( 0 ) )
+      : last( threads, -1 ), delay( delay ) {}
+
+      virtual void log( const log_message& m ) override
+      {
+         if( delay.count() > 0 )
+            std::this_thread::sleep_for( delay );
+
+         auto data = m.get_data();
+         std::lock_guard< std::mutex > lock( mtx );
+         if( data.contains( "t" ) )
+         {
+            size_t t = data["t"].as_uint64();
+            int64_t n = data["n"].as_int64();
+            if( n <= last[t] )
+               out_of_order = true;
+            last[t] = n;
+         }
+         ++count;
+      }
+
+      uint64_t delivered()
+      {
+         std::lock_guard< std::mutex > lock( mtx );
+         return count;
+      }
+
+      std::mutex                 mtx;
+      std::vector< int64_t >     last;
+      uint64_t                   count = 0;
+      bool                       out_of_order = false;
+      std::chrono::microseconds  delay;
+};
+
+// Messages are delivered on a background thread, so wait for them to arrive.
+static bool wait_for( const std::function< bool() >& done )
+{
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 30 );
+   while( !done() )
+   {
+      if( std::chrono::steady_clock::now() > deadline )
+         return false;
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+   }
+   return true;
+}
+
+static void log_from_threads( logger& lg, size_t threads, size_t per_thread )
+{
+   std::vector< std::thread > producers;
+   for( size_t t = 0; t < threads; ++t )
+   {
+      producers.emplace_back( [&lg, t, per_thread]()
+      {
+         for( size_t n = 0; n < per_thread; ++n )
+            lg.log( FC_LOG_MESSAGE( info, "message ${n}", ("t", t)("n", n) ) );
+      } );
+   }
+   for( auto& p : producers )
+      p.join();
+}
+
+BOOST_AUTO_TEST_SUITE(logger_tests)
+
+BOOST_AUTO_TEST_CASE(delivers_messages_in_order_per_thread)
+{
+   const size_t threads = 4;
+   const size_t per_thread = 2000;
+
+   logger lg( "logger_test_order" );
+   lg.set_log_level( log_level::info );
+   fc::shared_ptr< counting_appender > counter( new counting_appender( threads ) );
+   lg.add_appender( counter );
+
+   uint64_t dropped_before = logger::dropped_messages();
+   log_from_threads( lg, threads, per_thread );
+
+   BOOST_REQUIRE( wait_for( [&]()
+   {
+      return counter->delivered() + ( logger::dropped_messages() - dropped_before ) >= threads * per_thread;
+   } ) );
+   BOOST_CHECK_EQUAL( threads * per_thread, counter->delivered() + ( logger::dropped_messages() - dropped_before ) );
+   BOOST_CHECK( !counter->out_of_order );
+}
+
+BOOST_AUTO_TEST_CASE(full_queue_drops_and_counts)
+{
+   const size_t threads = 4;
+   const size_t per_thread = 10000;
+
+   // A slow appender backs up the queue, so some of the messages must be dropped
+   logger lg( "logger_test_drops" );
+   lg.set_log_level( log_level::info );
+   fc::shared_ptr< counting_appender > counter( new counting_appender( threads, std::chrono::microseconds( 20 ) ) );
+   lg.add_appender( counter );
+
+   uint64_t dropped_before = logger::dropped_messages();
+   log_from_threads( lg, threads, per_thread );
+   uint64_t dropped = logger::dropped_messages() - dropped_before;
+
+   BOOST_CHECK( dropped > 0 );
+   BOOST_REQUIRE( wait_for( [&]() { return counter->delivered() + dropped >= threads * per_thread; } ) );
+   BOOST_CHECK_EQUAL( threads * per_thread, counter->delivered() + dropped );
+   BOOST_CHECK( !counter->out_of_order );
+}
+
+BOOST_AUTO_TEST_CASE(appenders_added_while_delivering)
+{
+   logger lg( "logger_test_add" );
+   lg.set_log_level( log_level::info );
+   fc::shared_ptr< counting_appender > first( new counting_appender() );
+   lg.add_appender( first );
+
+   std::atomic< bool > stop( false );
+   std::thread producer( [&]()
+   {
+      while( !stop.load() )
+         lg.log( FC_LOG_MESSAGE( info, "busy" ) );
+   } );
+
+   std::vector< fc::shared_ptr< counting_appender > > added;
+   for( int i = 0; i < 200; ++i )
+   {
+      added.emplace_back( new counting_appender() );
+      lg.add_appender( added.back() );
+   }
+
+   stop = true;
+   producer.join();
+   BOOST_CHECK_EQUAL( 201u, lg.get_appenders().size() );
+
+   // Every appender receives messages logged after it was added
+   uint64_t before = added.back()->delivered();
+   BOOST_CHECK( wait_for( [&]()
+   {
+      // The queue may still be full from the producer, so log until a message gets through
+      lg.log( FC_LOG_MESSAGE( info, "last" ) );
+      return added.back()->delivered() > before;
+   } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
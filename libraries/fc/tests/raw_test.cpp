@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/array.hpp>
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/io/raw.hpp>
+
+#include <random>
+
+using namespace fc;
+
+// Vectors of trivially packable types are copied in bulk; the bytes must match packing
+// every element on its own.
+template< typename T >
+static void check_bulk_matches_elements( const std::vector<T>& v )
+{
+   static_assert( raw::is_trivially_packable<T>::value, "expected a bulk packed type" );
+
+   datastream<size_t> ss;
+   raw::pack( ss, unsigned_int( (uint32_t)v.size() ) );
+   for( const auto& e : v )
+      raw::pack( ss, e );
+   std::vector<char> expected( ss.tellp() );
+   datastream<char*> ds( expected.data(), expected.size() );
+   raw::pack( ds, unsigned_int( (uint32_t)v.size() ) );
+   for( const auto& e : v )
+      raw::pack( ds, e );
+
+   BOOST_REQUIRE_EQUAL( raw::pack_size( v ), expected.size() );
+   std::vector<char> packed = raw::pack_to_vector( v );
+   BOOST_REQUIRE( packed == expected );
+
+   std::vector<T> unpacked( 3 );
+   raw::unpack_from_vector( packed, unpacked );
+   BOOST_REQUIRE( raw::pack_to_vector( unpacked ) == packed );
+   BOOST_REQUIRE_EQUAL( unpacked.size(), v.size() );
+}
+
+BOOST_AUTO_TEST_SUITE(fc)
+
+BOOST_AUTO_TEST_CASE(raw_trivially_packable_types)
+{
+   BOOST_CHECK( raw::is_trivially_packable<uint8_t>::value );
+   BOOST_CHECK( raw::is_trivially_packable<int64_t>::value );
+   BOOST_CHECK( raw::is_trivially_packable<double>::value );
+   BOOST_CHECK( ( raw::is_trivially_packable< fc::array<unsigned char,65> >::value ) );
+   BOOST_CHECK( raw::is_trivially_packable<sha256>::value );
+   BOOST_CHECK( raw::is_trivially_packable<ripemd160>::value );
+
+   BOOST_CHECK( !raw::is_trivially_packable<bool>::value );
+   BOOST_CHECK( !raw::is_trivially_packable<std::string>::value );
+   BOOST_CHECK( !raw::is_trivially_packable<unsigned_int>::value );
+   BOOST_CHECK( ( !raw::is_trivially_packable< fc::array<std::string,2> >::value ) );
+}
+
+BOOST_AUTO_TEST_CASE(raw_bulk_vectors)
+{
+   std::mt19937 rng( 5 );
+   for( size_t n : { 0, 1, 2, 127, 128, 1000 } )
+   {
+      std::vector<uint16_t> u16;
+      std::vector<int64_t> i64;
+      std::vector< fc::array<unsigned char,65> > sigs( n );
+      std::vector<sha256> sha;
+      std::vector<ripemd160> rmd;
+      for( size_t i = 0; i < n; ++i )
+      {
+         u16.push_back( uint16_t( rng() ) );
+         i64.push_back( ( int64_t( rng() ) << 32 ) | rng() );
+         for( auto& c : sigs[i].data )
+            c = (unsigned char)rng();
+         sha.push_back( sha256::hash( std::to_string( i ) ) );
+         rmd.push_back( ripemd160::hash( std::to_string( i ) ) );
+      }
+
+      check_bulk_matches_elements( u16 );
+      check_bulk_matches_elements( i64 );
+      check_bulk_matches_elements( sigs );
+      check_bulk_matches_elements( sha );
+      check_bulk_matches_elements( rmd );
+   }
+}
+
+BOOST_AUTO_TEST_CASE(raw_bulk_vector_truncated)
+{
+   std::vector<uint32_t> v{ 1, 2, 3, 4 };
+   std::vector<char> packed = raw::pack_to_vector( v );
+   packed.pop_back();
+
+   std::vector<uint32_t> unpacked;
+   BOOST_CHECK_THROW( raw::unpack_from_vector( packed, unpacked ), fc::exception );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
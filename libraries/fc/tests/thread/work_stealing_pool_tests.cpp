@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/thread/thread.hpp>
+#include <fc/thread/work_stealing_pool.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(work_stealing_pool_tests)
+
+BOOST_AUTO_TEST_CASE(returns_value_from_function)
+{
+    work_stealing_pool pool(2);
+    BOOST_CHECK_EQUAL(2u, pool.size());
+    BOOST_CHECK_EQUAL(10, pool.async([]{return 10;}).wait());
+    BOOST_CHECK_EQUAL(20, fc::async(pool, []{return 20;}).wait());
+}
+
+BOOST_AUTO_TEST_CASE(runs_on_pool_threads)
+{
+    work_stealing_pool pool(4);
+    BOOST_CHECK(!pool.is_current());
+    BOOST_CHECK(pool.async([&pool]{return pool.is_current();}).wait());
+    BOOST_CHECK(pool.async([]{return std::this_thread::get_id();}).wait() != std::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_CASE(executes_many_tasks)
+{
+    work_stealing_pool pool(4);
+    std::vector<fc::future<uint64_t>> futures;
+    for (uint64_t i = 0; i < 10000; ++i)
+        futures.push_back(pool.async([i]{return i * i;}));
+
+    uint64_t sum = 0;
+    for (auto& f : futures)
+        sum += f.wait();
+    BOOST_CHECK_EQUAL(333283335000ull, sum);
+}
+
+BOOST_AUTO_TEST_CASE(nested_tasks_are_run)
+{
+    work_stealing_pool pool(4);
+    std::atomic<uint32_t> count(0);
+    pool.async([&]{
+        for (int i = 0; i < 100; ++i)
+            pool.async([&count]{++count;});
+    }).wait();
+
+    while (count.load() < 100)
+        std::this_thread::yield();
+    BOOST_CHECK_EQUAL(100u, count.load());
+}
+
+BOOST_AUTO_TEST_CASE(idle_threads_steal_work)
+{
+    // Every task is posted to the first thread's queue while it is busy, so the others only
+    // get to run them by stealing.
+    work_stealing_pool pool(4);
+    std::mutex mtx;
+    std::condition_variable cond;
+    bool release = false;
+    std::set<std::thread::id> ids;
+
+    pool.async([&]{
+        for (int i = 0; i < 64; ++i)
+            pool.async([&]{
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                std::lock_guard<std::mutex> lock(mtx);
+                ids.insert(std::this_thread::get_id());
+            });
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [&]{ return release; });
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        release = true;
+        cond.notify_all();
+    }
+    pool.quit();
+    BOOST_CHECK(ids.size() > 1);
+}
+
+BOOST_AUTO_TEST_CASE(propagates_exceptions)
+{
+    work_stealing_pool pool(2);
+    auto f = pool.async([]() -> int { FC_THROW_EXCEPTION(fc::invalid_arg_exception, "bad"); });
+    BOOST_CHECK_THROW(f.wait(), fc::invalid_arg_exception);
+}
+
+BOOST_AUTO_TEST_CASE(waits_from_fc_thread)
+{
+    work_stealing_pool pool(2);
+    fc::thread thread("my");
+    int result = thread.async([&pool]{
+        return pool.async([]{return 42;}).wait();
+    }).wait();
+    BOOST_CHECK_EQUAL(42, result);
+}
+
+BOOST_AUTO_TEST_CASE(quit_cancels_pending_tasks)
+{
+    work_stealing_pool pool(1);
+    std::atomic<bool> started(false);
+    std::atomic<bool> release(false);
+    auto blocker = pool.async([&]{
+        started = true;
+        while (!release.load())
+            std::this_thread::yield();
+    });
+    auto pending = pool.async([]{return 1;});
+
+    while (!started.load())
+        std::this_thread::yield();
+    std::thread releaser([&]{
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release = true;
+    });
+    pool.quit();
+    releaser.join();
+
+    blocker.wait();
+    BOOST_CHECK_THROW(pending.wait(), fc::canceled_exception);
+    BOOST_CHECK_THROW(pool.async([]{return 2;}).wait(), fc::canceled_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
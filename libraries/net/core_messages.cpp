@@ -45,6 +45,48 @@ namespace graphene { namespace net {
   const core_message_type_enum check_firewall_reply_message::type            = core_message_type_enum::check_firewall_reply_message_type;
   const core_message_type_enum get_current_connections_request_message::type = core_message_type_enum::get_current_connections_request_message_type;
   const core_message_type_enum get_current_connections_reply_message::type   = core_message_type_enum::get_current_connections_reply_message_type;
+  const core_message_type_enum compact_block_message::type                   = core_message_type_enum::compact_block_message_type;
+  const core_message_type_enum fetch_block_transactions_message::type        = core_message_type_enum::fetch_block_transactions_message_type;
+  const core_message_type_enum block_transactions_message::type              = core_message_type_enum::block_transactions_message_type;
+  const core_message_type_enum trx_batch_message::type                       = core_message_type_enum::trx_batch_message_type;
+
+  compact_block_message::compact_block_message(const item_hash_t& block_message_hash, const block_message& full_block) :
+    block_message_hash(block_message_hash),
+    block_id(full_block.block_id),
+    header(full_block.block)
+  {
+    short_transaction_ids.reserve(full_block.block.transactions.size());
+    for (const signed_transaction& trx : full_block.block.transactions)
+      short_transaction_ids.push_back(short_transaction_id(trx.id()));
+  }
+
+  uint64_t compact_block_message::short_transaction_id(const transaction_id_type& id)
+  {
+    uint64_t short_id;
+    memcpy(&short_id, id.data(), sizeof(short_id));
+    return short_id;
+  }
+
+  std::vector<trx_batch_message> trx_batch_message::split(std::vector<message> transactions)
+  {
+    // the transaction count in front of a batch packs to at most 5 bytes
+    const size_t empty_batch_size = 5;
+
+    std::vector<trx_batch_message> batches;
+    size_t batch_size = 0;
+    for (message& transaction : transactions)
+    {
+      size_t transaction_size = fc::raw::pack_size(transaction);
+      if (batches.empty() || batch_size + transaction_size > MAX_MESSAGE_SIZE)
+      {
+        batches.emplace_back();
+        batch_size = empty_batch_size;
+      }
+      batches.back().transactions.push_back(std::move(transaction));
+      batch_size += transaction_size;
+    }
+    return batches;
+  }
 
 } } // graphene::net
 
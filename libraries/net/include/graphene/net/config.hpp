@@ -81,6 +81,22 @@
 
 #define GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING      200
 
+/**
+ * During sync, each peer is asked for as many blocks as it has recently been able
+ * to deliver in this many milliseconds, but never fewer than the minimum below or
+ * more than the configured maximum_blocks_per_peer_during_syncing.
+ */
+#define GRAPHENE_NET_SYNC_WINDOW_TARGET_MILLISECONDS         2000
+#define GRAPHENE_NET_MIN_BLOCKS_PER_PEER_DURING_SYNCING      10
+
+/**
+ * A sync block that has been outstanding for longer than this multiple of the
+ * holding peer's average block latency (and at least the minimum delay) is also
+ * requested from an idle peer, so one slow peer can't stall the whole sync.
+ */
+#define GRAPHENE_NET_SYNC_STRAGGLER_LATENCY_MULTIPLE         3
+#define GRAPHENE_NET_SYNC_STRAGGLER_MIN_DELAY_MILLISECONDS   1000
+
 /**
  * During normal operation, how many items will be fetched from each
  * peer at a time.  This will only come into play when the network
@@ -94,6 +110,20 @@
  */
 #define GRAPHENE_NET_MAX_ITEMS_PER_PEER_DURING_NORMAL_OPERATION  1
 
+/**
+ * Peers that advertise "trx_batches" in their hello are asked for up to this
+ * many transactions at a time, and send them back in trx_batch_messages of up to
+ * MAX_MESSAGE_SIZE instead of one trx_message each.
+ */
+#define GRAPHENE_NET_MAX_TRX_PER_BATCH                       100
+
+/**
+ * New transaction inventory is held for this long before it is advertised, so
+ * transactions arriving close together are announced in one inventory message.
+ * Block inventory is always advertised immediately.
+ */
+#define GRAPHENE_NET_DEFAULT_INVENTORY_COALESCING_MILLISECONDS  50
+
 /**
  * Instead of fetching all item IDs from a peer, then fetching all blocks
  * from a peer, we will interleave them.  Fetch at least this many block IDs,
@@ -137,3 +167,24 @@
 #define GRAPHENE_NET_PORT_WAIT_DELAY_SECONDS                   5
 
 #define GRAPHENE_NET_MAX_PEERDB_SIZE                           1000
+
+/**
+ * How often changes to the peer database are appended to its file.  Writes happen on the
+ * node's file i/o thread, so this only bounds how much is lost if the process dies.
+ */
+#define GRAPHENE_NET_PEER_DATABASE_FLUSH_INTERVAL_SECONDS      30
+
+/**
+ * stcp_socket encrypts and decrypts through buffers of this size, so a large message
+ * goes out in a few big socket writes instead of many 4KiB ones.
+ */
+#define GRAPHENE_NET_STCP_BUFFER_SIZE                          (64*1024)
+
+/**
+ * Reads and writes of at least this many bytes do their AES work on one of the
+ * stcp crypto threads, and the p2p thread services other peers while it runs.
+ * Smaller ones are handled inline, because the handoff would cost more than the
+ * encryption.
+ */
+#define GRAPHENE_NET_STCP_CRYPTO_OFFLOAD_THRESHOLD             (16*1024)
+#define GRAPHENE_NET_STCP_CRYPTO_THREADS                       2
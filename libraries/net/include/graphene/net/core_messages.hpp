@@ -25,6 +25,7 @@
 
 #include <graphene/net/config.hpp>
 #include <morphene/protocol/block.hpp>
+#include <graphene/net/message.hpp>
 
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/crypto/elliptic.hpp>
@@ -86,6 +87,10 @@ namespace graphene { namespace net {
     check_firewall_reply_message_type            = 5015,
     get_current_connections_request_message_type = 5016,
     get_current_connections_reply_message_type   = 5017,
+    compact_block_message_type                   = 5018,
+    fetch_block_transactions_message_type        = 5019,
+    block_transactions_message_type              = 5020,
+    trx_batch_message_type                       = 5021,
     core_message_type_last                       = 5099
   };
 
@@ -115,6 +120,75 @@ namespace graphene { namespace net {
 
    };
 
+  /**
+   * A block relayed as its header plus a short id for each transaction.  The receiver rebuilds
+   * the block from transactions it has already seen and fetches only the missing ones with a
+   * fetch_block_transactions_message.  Compact blocks are requested by sending a
+   * fetch_items_message with this item type to peers that advertise "compact_blocks" in their
+   * hello user data; the item hashes are the message hashes of the full block_messages.
+   */
+  struct compact_block_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                              block_message_hash;
+    block_id_type                            block_id;
+    morphene::protocol::signed_block_header  header;
+    std::vector<uint64_t>                    short_transaction_ids;
+
+    compact_block_message() {}
+    compact_block_message(const item_hash_t& block_message_hash, const block_message& full_block);
+
+    /** the first eight bytes of the transaction id */
+    static uint64_t short_transaction_id(const transaction_id_type& id);
+  };
+
+  struct fetch_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t           block_message_hash;
+    std::vector<uint32_t> transaction_indexes;
+
+    fetch_block_transactions_message() {}
+    fetch_block_transactions_message(const item_hash_t& block_message_hash, std::vector<uint32_t> transaction_indexes) :
+      block_message_hash(block_message_hash),
+      transaction_indexes(std::move(transaction_indexes))
+    {}
+  };
+
+  /** the transactions asked for by a fetch_block_transactions_message, in the order requested */
+  struct block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                     block_message_hash;
+    std::vector<signed_transaction> transactions;
+
+    block_transactions_message() {}
+    block_transactions_message(const item_hash_t& block_message_hash) :
+      block_message_hash(block_message_hash)
+    {}
+  };
+
+  /**
+   * the reply to a fetch_items_message for trx_batch_message_type: all of the requested
+   * transactions we have, in as few messages as fit in MAX_MESSAGE_SIZE.  They keep their
+   * original trx_message encoding so their message ids don't change
+   */
+  struct trx_batch_message
+  {
+    static const core_message_type_enum type;
+
+    std::vector<message> transactions;
+
+    /**
+     * splits transactions, in order, into batches that each pack to no more than
+     * MAX_MESSAGE_SIZE.  A transaction too large to share a batch gets one of its own
+     */
+    static std::vector<trx_batch_message> split(std::vector<message> transactions);
+  };
+
   struct item_ids_inventory_message
   {
     static const core_message_type_enum type;
@@ -421,10 +495,23 @@ FC_REFLECT_ENUM( graphene::net::core_message_type_enum,
                  (check_firewall_reply_message_type)
                  (get_current_connections_request_message_type)
                  (get_current_connections_reply_message_type)
+                 (compact_block_message_type)
+                 (fetch_block_transactions_message_type)
+                 (block_transactions_message_type)
+                 (trx_batch_message_type)
                  (core_message_type_last) )
 
 FC_REFLECT( graphene::net::trx_message, (trx) )
 FC_REFLECT( graphene::net::block_message, (block)(block_id) )
+FC_REFLECT( graphene::net::compact_block_message, (block_message_hash)
+                                             (block_id)
+                                             (header)
+                                             (short_transaction_ids) )
+FC_REFLECT( graphene::net::fetch_block_transactions_message, (block_message_hash)
+                                                        (transaction_indexes) )
+FC_REFLECT( graphene::net::block_transactions_message, (block_message_hash)
+                                                  (transactions) )
+FC_REFLECT( graphene::net::trx_batch_message, (transactions) )
 
 FC_REFLECT( graphene::net::item_id, (item_type)
                                (item_hash) )
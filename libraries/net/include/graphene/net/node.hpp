@@ -184,6 +184,46 @@ namespace graphene { namespace net {
       fc::variant_object info;
    };
 
+   /** what we know about one connected peer, see node::get_network_telemetry() */
+   struct peer_telemetry
+   {
+      fc::optional<fc::ip::endpoint> host;
+      node_id_t          node_id;
+      std::string        user_agent;
+      fc::time_point     connection_time;
+      fc::microseconds   round_trip_delay;
+      fc::microseconds   clock_offset;
+      uint64_t           queued_message_bytes = 0;
+      uint32_t           items_in_flight = 0; /// items requested during normal operation that haven't arrived
+      uint32_t           sync_items_in_flight = 0; /// sync blocks requested that haven't arrived
+      uint32_t           sync_items_to_get = 0; /// block ids the peer has offered that we haven't fetched
+      uint32_t           sync_window_size = 0;
+      uint64_t           sync_bytes_per_second = 0;
+      fc::microseconds   average_sync_item_latency;
+      uint64_t           bytes_sent = 0;
+      uint64_t           bytes_received = 0;
+      bool               we_need_sync_items_from_peer = false;
+      bool               peer_needs_sync_items_from_us = false;
+   };
+
+   /**
+    *  A snapshot of the node's network state.  It is taken on the p2p thread every
+    *  GRAPHENE_NET_BANDWIDTH_MONITOR_INTERVAL_SECONDS, so readers never wait on that thread.
+    */
+   struct network_telemetry
+   {
+      fc::time_point               snapshot_time;
+      uint32_t                     upload_bytes_per_second = 0; /// over the last second
+      uint32_t                     download_bytes_per_second = 0;
+      uint32_t                     upload_rate_one_minute = 0; /// average bytes per second over the last full minute
+      uint32_t                     download_rate_one_minute = 0;
+      uint32_t                     active_sync_requests = 0;
+      uint32_t                     sync_backlog_size = 0; /// sync blocks received but waiting on earlier blocks
+      uint32_t                     items_to_fetch = 0;
+      std::vector<peer_telemetry>  peers;
+      fc::variant_object           delegate_call_statistics;
+   };
+
    /**
     *  @class node
     *  @brief provides application independent P2P broadcast and data synchronization
@@ -295,6 +335,9 @@ namespace graphene { namespace net {
         std::vector<potential_peer_record> get_potential_peers() const;
 
         fc::variant_object get_call_statistics() const;
+
+        /** the most recent snapshot, or null before the first one is taken.  Safe to call from any thread */
+        std::shared_ptr<const network_telemetry> get_network_telemetry() const;
       private:
         std::unique_ptr<detail::node_impl, detail::node_impl_deleter> my;
    };
@@ -329,3 +372,10 @@ namespace graphene { namespace net {
 
 FC_REFLECT(graphene::net::message_propagation_data, (received_time)(validated_time)(originating_peer));
 FC_REFLECT( graphene::net::peer_status, (version)(host)(info) );
+FC_REFLECT( graphene::net::peer_telemetry, (host)(node_id)(user_agent)(connection_time)(round_trip_delay)(clock_offset)
+                                           (queued_message_bytes)(items_in_flight)(sync_items_in_flight)(sync_items_to_get)
+                                           (sync_window_size)(sync_bytes_per_second)(average_sync_item_latency)
+                                           (bytes_sent)(bytes_received)(we_need_sync_items_from_peer)(peer_needs_sync_items_from_us) );
+FC_REFLECT( graphene::net::network_telemetry, (snapshot_time)(upload_bytes_per_second)(download_bytes_per_second)
+                                              (upload_rate_one_minute)(download_rate_one_minute)(active_sync_requests)
+                                              (sync_backlog_size)(items_to_fetch)(peers)(delegate_call_statistics) );
@@ -208,7 +208,8 @@ namespace graphene { namespace net
       fc::optional<std::string> platform;
       fc::optional<uint32_t> bitness;
       fc::optional<morphene::protocol::chain_id_type> chain_id;
-
+      bool supports_compact_blocks = false; /// the peer advertised "compact_blocks" in its hello user data
+      bool supports_trx_batches = false; /// the peer advertised "trx_batches" in its hello user data
       // for inbound connections, these fields record what the peer sent us in
       // its hello message.  For outbound, they record what we sent the peer
       // in our hello message
@@ -232,6 +233,10 @@ namespace graphene { namespace net
       item_hash_t last_block_delegate_has_seen; /// the hash of the last block  this peer has told us about that the peer knows
       fc::time_point_sec last_block_time_delegate_has_seen;
       bool inhibit_fetching_sync_blocks = false;
+      uint32_t sync_window_size = GRAPHENE_NET_MIN_BLOCKS_PER_PEER_DURING_SYNCING; /// how many sync blocks we'll request from this peer at a time, sized from the measurements below
+      uint64_t sync_bytes_per_second = 0; /// moving average of the rate sync blocks arrive from this peer
+      fc::microseconds average_sync_item_interval; /// moving average of the time between consecutive sync blocks from this peer
+      fc::microseconds average_sync_item_latency; /// moving average of the time from requesting a sync block to receiving it
       /// @}
 
       /// latency timing data
@@ -259,6 +264,14 @@ namespace graphene { namespace net
       timestamped_items_set_type inventory_advertised_to_peer;
 
       item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+
+      /// compact blocks received from this peer that are waiting for a block_transactions_message, keyed by block message hash
+      struct partial_compact_block
+      {
+        compact_block_message compact_block;
+        std::vector<fc::optional<signed_transaction> > transactions;
+      };
+      std::unordered_map<item_hash_t, partial_compact_block> partial_compact_blocks;
       /// @}
 
       // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
@@ -298,6 +311,7 @@ namespace graphene { namespace net
 
       uint64_t get_total_bytes_sent() const;
       uint64_t get_total_bytes_received() const;
+      size_t get_total_queued_messages_size() const { return _total_queued_messages_size; }
 
       fc::time_point get_last_message_sent_time() const;
       fc::time_point get_last_message_received_time() const;
@@ -32,6 +32,8 @@
 #include <fc/exception/exception.hpp>
 #include <fc/io/raw.hpp>
 
+namespace fc { class thread; }
+
 namespace graphene { namespace net {
 
   enum potential_peer_last_connection_disposition
@@ -52,6 +54,7 @@ namespace graphene { namespace net {
     uint32_t                          number_of_successful_connection_attempts;
     uint32_t                          number_of_failed_connection_attempts;
     fc::optional<fc::exception>       last_error;
+    fc::microseconds                  average_round_trip_delay; /// smoothed over our time-sync replies from this peer, zero if never measured
 
     potential_peer_record() :
       number_of_successful_connection_attempts(0),
@@ -66,6 +69,21 @@ namespace graphene { namespace net {
       number_of_successful_connection_attempts(0),
       number_of_failed_connection_attempts(0)
     {}  
+
+    /**
+     * Orders candidates for outgoing connections, lower is better.  Peers we have reached
+     * before are preferred over ones we have only heard about, each failed attempt counts
+     * as much as a second of round trip delay, and an unmeasured delay counts as a slow peer.
+     */
+    int64_t connection_score() const
+    {
+      int64_t score = average_round_trip_delay.count() > 0 ? average_round_trip_delay.count() : fc::seconds(1).count();
+      score += int64_t(number_of_failed_connection_attempts) * fc::seconds(1).count();
+      score -= int64_t(std::min<uint32_t>(number_of_successful_connection_attempts, 10)) * fc::milliseconds(100).count();
+      if (last_connection_disposition == last_connection_succeeded)
+        score -= fc::seconds(1).count();
+      return score;
+    }
   };
 
   namespace detail
@@ -98,9 +116,20 @@ namespace graphene { namespace net {
     peer_database();
     ~peer_database();
 
-    void open(const fc::path& databaseFilename);
+    /**
+     * The database is kept as an append-only log of raw-packed records: changes are
+     * buffered in memory and appended by flush(), and the file is rewritten in full
+     * when the log holds more than twice the live records plus GRAPHENE_NET_MAX_PEERDB_SIZE,
+     * or after a write has failed.  If io_thread is
+     * given the file writes are done there instead of on the calling thread.
+     * The file starts with a format version, and a file of another version is
+     * discarded.  A legacy JSON database with the same name and a .json extension
+     * is imported.
+     */
+    void open(const fc::path& databaseFilename, fc::thread* io_thread = nullptr);
     void close();
     void clear();
+    void flush();
 
     void erase(const fc::ip::endpoint& endpointToErase);
 
@@ -119,4 +148,4 @@ namespace graphene { namespace net {
 } } // end namespace graphene::net
 
 FC_REFLECT_ENUM(graphene::net::potential_peer_last_connection_disposition, (never_attempted_to_connect)(last_connection_failed)(last_connection_rejected)(last_connection_handshaking_failed)(last_connection_succeeded))
-FC_REFLECT(graphene::net::potential_peer_record, (endpoint)(last_seen_time)(last_connection_disposition)(last_connection_attempt_time)(number_of_successful_connection_attempts)(number_of_failed_connection_attempts)(last_error) )
+FC_REFLECT(graphene::net::potential_peer_record, (endpoint)(last_seen_time)(last_connection_disposition)(last_connection_attempt_time)(number_of_successful_connection_attempts)(number_of_failed_connection_attempts)(last_error)(average_round_trip_delay) )
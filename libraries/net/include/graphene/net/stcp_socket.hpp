@@ -23,6 +23,7 @@
  */
 #pragma once
 #include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
 #include <fc/crypto/aes.hpp>
 #include <fc/crypto/elliptic.hpp>
 
@@ -59,6 +60,9 @@ class stcp_socket : public virtual fc::iostream
   private:
     void do_key_exchange();
 
+    template<typename Functor>
+    void run_crypto_task( size_t len, Functor&& crypto_task );
+
     fc::sha512           _shared_secret;
     fc::ecc::private_key _priv_key;
     fc::array<char,8>    _buf;
@@ -66,6 +70,7 @@ class stcp_socket : public virtual fc::iostream
     fc::tcp_socket       _sock;
     fc::aes_encoder      _send_aes;
     fc::aes_decoder      _recv_aes;
+    fc::thread*          _crypto_thread;
     std::shared_ptr<char> _read_buffer;
     std::shared_ptr<char> _write_buffer;
 #ifndef NDEBUG
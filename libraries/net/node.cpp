@@ -137,7 +137,7 @@ namespace graphene { namespace net {
       struct message_info
       {
         message_hash_type message_hash;
-        message           message_body;
+        std::shared_ptr<const message> message_body; // shared with anyone serving the message, so lookups don't copy it
         uint32_t          block_clock_when_received;
 
         // for network performance stats
@@ -145,12 +145,12 @@ namespace graphene { namespace net {
         fc::uint160_t     message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is the transaction id, if it's a block, it's the block_id)
 
         message_info( const message_hash_type& message_hash,
-                      const message&           message_body,
+                      std::shared_ptr<const message> message_body,
                       uint32_t                 block_clock_when_received,
                       const message_propagation_data& propagation_data,
                       fc::uint160_t            message_contents_hash ) :
           message_hash( message_hash ),
-          message_body( message_body ),
+          message_body( std::move( message_body ) ),
           block_clock_when_received( block_clock_when_received ),
           propagation_data( propagation_data ),
           message_contents_hash( message_contents_hash )
@@ -177,8 +177,9 @@ namespace graphene { namespace net {
       void block_accepted();
       void cache_message( const message& message_to_cache, const message_hash_type& hash_of_message_to_cache,
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
-      message get_message( const message_hash_type& hash_of_message_to_lookup );
+      std::shared_ptr<const message> get_message( const message_hash_type& hash_of_message_to_lookup ) const;
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
+      fc::optional<signed_transaction> find_transaction_by_short_id( uint64_t short_transaction_id ) const;
       size_t size() const { return _message_cache.size(); }
     };
 
@@ -196,13 +197,13 @@ namespace graphene { namespace net {
                                                      const fc::uint160_t& message_content_hash )
     {
       _message_cache.insert( message_info(hash_of_message_to_cache,
-                                         message_to_cache,
+                                         std::make_shared<const message>( message_to_cache ),
                                          block_clock,
                                          propagation_data,
                                          message_content_hash ) );
     }
 
-    message blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
+    std::shared_ptr<const message> blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup ) const
     {
       message_cache_container::index<message_hash_index>::type::const_iterator iter =
          _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
@@ -223,6 +224,29 @@ namespace graphene { namespace net {
       FC_THROW_EXCEPTION(  fc::key_not_found_exception, "Requested message not in cache" );
     }
 
+    fc::optional<signed_transaction> blockchain_tied_message_cache::find_transaction_by_short_id( uint64_t short_transaction_id ) const
+    {
+      // the contents hash of a transaction is its id, and ids are ordered bytewise, so every
+      // transaction whose id starts with the short id sits in one range of the index
+      fc::uint160_t range_start;
+      memcpy( range_start.data(), &short_transaction_id, sizeof(short_transaction_id) );
+
+      fc::optional<signed_transaction> result;
+      const auto& contents_index = _message_cache.get<message_contents_hash_index>();
+      for( auto iter = contents_index.lower_bound( range_start );
+           iter != contents_index.end() && compact_block_message::short_transaction_id( iter->message_contents_hash ) == short_transaction_id;
+           ++iter )
+      {
+        if( iter->message_body->msg_type != trx_message_type )
+          continue;
+        // an ambiguous short id can't be resolved locally, treat it as missing
+        if( result )
+          return fc::optional<signed_transaction>();
+        result = iter->message_body->as<trx_message>().trx;
+      }
+      return result;
+    }
+
     // when requesting items from peers, we want to prioritize any blocks before
     // transactions, but otherwise request items in the order we heard about them
     struct prioritized_item_id
@@ -382,10 +406,11 @@ namespace graphene { namespace net {
 #ifdef P2P_IN_DEDICATED_THREAD
       std::shared_ptr<fc::thread> _thread;
 #endif // P2P_IN_DEDICATED_THREAD
+      std::unique_ptr<fc::thread> _file_io_thread; /// writes the peer database and node configuration so the p2p thread never waits on the disk
       std::unique_ptr<statistics_gathering_node_delegate_wrapper> _delegate;
 
 #define NODE_CONFIGURATION_FILENAME      "node_config.json"
-#define POTENTIAL_PEER_DATABASE_FILENAME "peers.json"
+#define POTENTIAL_PEER_DATABASE_FILENAME "peers.dat"
       fc::path             _node_configuration_directory;
       node_configuration   _node_configuration;
 
@@ -418,9 +443,26 @@ namespace graphene { namespace net {
 
       typedef std::unordered_map<graphene::net::block_id_type, fc::time_point> active_sync_requests_map;
 
+      struct sync_block_id_index{};
+      struct sync_block_number_index{};
+      struct sync_block_number_key
+      {
+        typedef uint32_t result_type;
+        uint32_t operator()( const graphene::net::block_message& message ) const { return message.block.block_num(); }
+      };
+      typedef boost::multi_index_container<graphene::net::block_message,
+                                           bmi::indexed_by<bmi::hashed_unique<bmi::tag<sync_block_id_index>,
+                                                                              bmi::member<graphene::net::block_message, block_id_type, &graphene::net::block_message::block_id>,
+                                                                              std::hash<block_id_type> >,
+                                                           bmi::ordered_non_unique<bmi::tag<sync_block_number_index>,
+                                                                                   sync_block_number_key> >
+                                           > sync_block_backlog_type;
+
       active_sync_requests_map              _active_sync_requests; /// list of sync blocks we've asked for from peers but have not yet received
-      std::list<graphene::net::block_message> _new_received_sync_items; /// list of sync blocks we've just received but haven't yet tried to process
-      std::list<graphene::net::block_message> _received_sync_items; /// list of sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
+      /// sync blocks that were straggling and have also been requested from a second peer, mapped to
+      /// whether the first of the two copies has arrived yet
+      std::unordered_map<item_hash_t, bool> _duplicate_sync_requests;
+      sync_block_backlog_type               _received_sync_items; /// sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
       // @}
 
       fc::future<void> _process_backlog_of_sync_blocks_done;
@@ -449,6 +491,8 @@ namespace graphene { namespace net {
       fc::promise<void>::ptr        _retrigger_advertise_inventory_loop_promise;
       fc::future<void>              _advertise_inventory_loop_done;
       std::unordered_set<item_id>   _new_inventory; /// list of items we have received but not yet advertised to our peers
+      bool                          _new_inventory_contains_block = false;
+      bool                          _coalescing_new_inventory = false; /// true while the loop holds transaction inventory to advertise it in one message
       // @}
 
       fc::future<void>     _terminate_inactive_connections_loop_done;
@@ -508,9 +552,14 @@ namespace graphene { namespace net {
 
       fc::time_point_sec _bandwidth_monitor_last_update_time;
       fc::future<void> _bandwidth_monitor_loop_done;
+      /// replaced with std::atomic_store on the p2p thread, read with std::atomic_load from any thread
+      std::shared_ptr<const network_telemetry> _network_telemetry;
 
       fc::future<void> _dump_node_status_task_done;
 
+      fc::future<void> _flush_peer_database_task_done;
+      fc::future<void> _node_configuration_saved;
+
       /* We have two alternate paths through the schedule_peer_for_deletion code -- one that
        * uses a mutex to prevent one fiber from adding items to the queue while another is deleting
        * items from it, and one that doesn't.  The one that doesn't is simpler and more efficient
@@ -549,6 +598,9 @@ namespace graphene { namespace net {
       bool have_already_received_sync_item( const item_hash_t& item_hash );
       void request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request );
       void request_sync_items_from_peer( const peer_connection_ptr& peer, const std::vector<item_hash_t>& items_to_request );
+      void record_sync_item_received( peer_connection* originating_peer, const item_hash_t& item_hash, uint32_t message_size );
+      bool is_straggling_sync_request( const item_hash_t& item_hash, fc::time_point now );
+      bool forget_duplicate_sync_request( const item_hash_t& item_hash );
       void fetch_sync_items_loop();
       void trigger_fetch_sync_items_loop();
 
@@ -564,7 +616,9 @@ namespace graphene { namespace net {
       void fetch_updated_peer_lists_loop();
       void update_bandwidth_data(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second);
       void bandwidth_monitor_loop();
+      void publish_network_telemetry(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second);
       void dump_node_status_task();
+      void flush_peer_database_task();
 
       bool is_accepting_new_connections();
       bool is_wanting_new_connections();
@@ -637,13 +691,28 @@ namespace graphene { namespace net {
       void on_get_current_connections_reply_message(peer_connection* originating_peer,
                                                     const get_current_connections_reply_message& get_current_connections_reply_message_received);
 
+      void on_trx_batch_message(peer_connection* originating_peer,
+                                const trx_batch_message& trx_batch_message_received);
+
+      void on_compact_block_message(peer_connection* originating_peer,
+                                    const compact_block_message& compact_block_message_received);
+
+      void on_fetch_block_transactions_message(peer_connection* originating_peer,
+                                               const fetch_block_transactions_message& fetch_block_transactions_message_received);
+
+      void on_block_transactions_message(peer_connection* originating_peer,
+                                         const block_transactions_message& block_transactions_message_received);
+
+      void process_reconstructed_compact_block(peer_connection* originating_peer, const peer_connection::partial_compact_block& partial_block);
+
       void on_connection_closed(peer_connection* originating_peer) override;
 
       void send_sync_block_to_node_delegate(const graphene::net::block_message& block_message_to_send);
       void process_backlog_of_sync_blocks();
       void trigger_process_backlog_of_sync_blocks();
       void process_block_during_sync(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
-      void process_block_during_normal_operation(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
+      void process_block_during_normal_operation(peer_connection* originating_peer, const message& message_to_process,
+                                                 const graphene::net::block_message& block_message, const message_hash_type& message_hash);
       void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
 
       void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
@@ -694,6 +763,8 @@ namespace graphene { namespace net {
       uint32_t                 get_connection_count() const;
 
       void broadcast(const message& item_to_broadcast, const message_propagation_data& propagation_data);
+      void broadcast(const message& item_to_broadcast, const message_propagation_data& propagation_data,
+                     const message_hash_type& hash_of_item_to_broadcast, const fc::uint160_t& hash_of_message_contents);
       void broadcast(const message& item_to_broadcast);
       void sync_from(const item_id& current_head_block, const std::vector<uint32_t>& hard_fork_block_numbers);
       bool is_connected() const;
@@ -834,6 +905,7 @@ namespace graphene { namespace net {
       fc::rand_pseudo_bytes(&_node_id.data[0], (int)_node_id.size());
 
       _shutdownNotifier.reset(new fc::promise<void>("Node shutdown notifier"));
+      _file_io_thread.reset(new fc::thread("p2p_file_io"));
     }
 
     node_impl::~node_impl()
@@ -881,19 +953,18 @@ namespace graphene { namespace net {
       if( fc::exists(_node_configuration_directory ) )
       {
         fc::path configuration_file_name( _node_configuration_directory / NODE_CONFIGURATION_FILENAME );
-        try
+        _node_configuration_saved = _file_io_thread->async( [configuration = _node_configuration, configuration_file_name]()
         {
-          fc::json::save_to_file( _node_configuration, configuration_file_name );
-        }
-        catch (const fc::canceled_exception&)
-        {
-          throw;
-        }
-        catch ( const fc::exception& except )
-        {
-          elog( "error writing node configuration to file ${filename}: ${error}",
-               ( "filename", configuration_file_name )("error", except.to_detail_string() ) );
-        }
+          try
+          {
+            fc::json::save_to_file( configuration, configuration_file_name );
+          }
+          catch ( const fc::exception& except )
+          {
+            elog( "error writing node configuration to file ${filename}: ${error}",
+                 ( "filename", configuration_file_name )("error", except.to_detail_string() ) );
+          }
+        }, "save_node_configuration" );
       }
     }
 
@@ -932,9 +1003,9 @@ namespace graphene { namespace net {
             bool initiated_connection_this_pass = false;
             _potential_peer_database_updated = false;
 
-            for (peer_database::iterator iter = _potential_peer_db.begin();
-                 iter != _potential_peer_db.end() && is_wanting_new_connections();
-                 ++iter)
+            // collect everyone we're allowed to try right now, then try the best scoring ones first
+            std::vector<potential_peer_record> candidates;
+            for (peer_database::iterator iter = _potential_peer_db.begin(); iter != _potential_peer_db.end(); ++iter)
             {
               fc::microseconds delay_until_retry = fc::seconds((iter->number_of_failed_connection_attempts + 1) * _node_configuration.peer_connection_retry_timeout);
 
@@ -943,10 +1014,17 @@ namespace graphene { namespace net {
                     iter->last_connection_disposition != last_connection_rejected &&
                     iter->last_connection_disposition != last_connection_handshaking_failed) ||
                    (fc::time_point::now() - iter->last_connection_attempt_time) > delay_until_retry))
-              {
-                connect_to_endpoint(iter->endpoint);
-                initiated_connection_this_pass = true;
-              }
+                candidates.push_back(*iter);
+            }
+            std::stable_sort(candidates.begin(), candidates.end(),
+                             [](const potential_peer_record& a, const potential_peer_record& b) { return a.connection_score() < b.connection_score(); });
+
+            for (const potential_peer_record& candidate : candidates)
+            {
+              if (!is_wanting_new_connections())
+                break;
+              connect_to_endpoint(candidate.endpoint);
+              initiated_connection_this_pass = true;
             }
 
             if (!initiated_connection_this_pass && !_potential_peer_database_updated)
@@ -1010,10 +1088,8 @@ namespace graphene { namespace net {
     bool node_impl::have_already_received_sync_item( const item_hash_t& item_hash )
     {
       VERIFY_CORRECT_THREAD();
-      return std::find_if(_received_sync_items.begin(), _received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _received_sync_items.end() ||
-             std::find_if(_new_received_sync_items.begin(), _new_received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _new_received_sync_items.end();                          ;
+      const auto& id_index = _received_sync_items.get<sync_block_id_index>();
+      return id_index.find(item_hash) != id_index.end();
     }
 
     void node_impl::request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request )
@@ -1041,6 +1117,86 @@ namespace graphene { namespace net {
       peer->send_message(fetch_items_message(graphene::net::block_message_type, items_to_request));
     }
 
+    void node_impl::record_sync_item_received( peer_connection* originating_peer, const item_hash_t& item_hash, uint32_t message_size )
+    {
+      VERIFY_CORRECT_THREAD();
+      fc::time_point now = fc::time_point::now();
+
+      // last_sync_item_received_time is also reset when we send a batch of requests, so the
+      // first block of each batch includes the round trip to the peer
+      fc::microseconds interval = now - originating_peer->last_sync_item_received_time;
+      originating_peer->last_sync_item_received_time = now;
+      if (interval.count() > 0)
+      {
+        uint64_t bytes_per_second = uint64_t(message_size) * 1000000 / interval.count();
+        if (originating_peer->average_sync_item_interval.count() == 0)
+        {
+          originating_peer->average_sync_item_interval = interval;
+          originating_peer->sync_bytes_per_second = bytes_per_second;
+        }
+        else
+        {
+          originating_peer->average_sync_item_interval = fc::microseconds((originating_peer->average_sync_item_interval.count() * 7 +
+                                                                           interval.count()) / 8);
+          originating_peer->sync_bytes_per_second = (originating_peer->sync_bytes_per_second * 7 + bytes_per_second) / 8;
+        }
+      }
+
+      // a straggler's request time is when the first peer was asked, so it says nothing about
+      // the latency of either peer
+      auto request_iter = _active_sync_requests.find(item_hash);
+      if (request_iter != _active_sync_requests.end() &&
+          _duplicate_sync_requests.find(item_hash) == _duplicate_sync_requests.end())
+      {
+        fc::microseconds latency = now - request_iter->second;
+        if (originating_peer->average_sync_item_latency.count() == 0)
+          originating_peer->average_sync_item_latency = latency;
+        else
+          originating_peer->average_sync_item_latency = fc::microseconds((originating_peer->average_sync_item_latency.count() * 7 +
+                                                                          latency.count()) / 8);
+      }
+
+      // ask for as many blocks as the peer can deliver in the target time
+      uint64_t window_size = GRAPHENE_NET_MIN_BLOCKS_PER_PEER_DURING_SYNCING;
+      if (originating_peer->average_sync_item_interval.count() > 0)
+        window_size = std::max<uint64_t>(window_size, uint64_t(GRAPHENE_NET_SYNC_WINDOW_TARGET_MILLISECONDS) * 1000 /
+                                                      originating_peer->average_sync_item_interval.count());
+      originating_peer->sync_window_size = (uint32_t)std::min<uint64_t>(window_size, _node_configuration.maximum_blocks_per_peer_during_syncing);
+    }
+
+    bool node_impl::is_straggling_sync_request( const item_hash_t& item_hash, fc::time_point now )
+    {
+      VERIFY_CORRECT_THREAD();
+      auto request_iter = _active_sync_requests.find(item_hash);
+      if (request_iter == _active_sync_requests.end() ||
+          _duplicate_sync_requests.find(item_hash) != _duplicate_sync_requests.end()) // only ever ask a second peer
+        return false;
+
+      for (const peer_connection_ptr& peer : _active_connections)
+      {
+        if (peer->sync_items_requested_from_peer.find(item_hash) != peer->sync_items_requested_from_peer.end())
+        {
+          fc::microseconds threshold = std::max(fc::milliseconds(GRAPHENE_NET_SYNC_STRAGGLER_MIN_DELAY_MILLISECONDS),
+                                                fc::microseconds(peer->average_sync_item_latency.count() * GRAPHENE_NET_SYNC_STRAGGLER_LATENCY_MULTIPLE));
+          return now - request_iter->second > threshold;
+        }
+      }
+      return false;
+    }
+
+    // Called when a peer we asked for a straggling sync block will no longer send it.  Returns
+    // true if the block is still on its way from the other peer we asked
+    bool node_impl::forget_duplicate_sync_request( const item_hash_t& item_hash )
+    {
+      VERIFY_CORRECT_THREAD();
+      auto duplicate_iter = _duplicate_sync_requests.find(item_hash);
+      if (duplicate_iter == _duplicate_sync_requests.end())
+        return false;
+      bool first_copy_received = duplicate_iter->second;
+      _duplicate_sync_requests.erase(duplicate_iter);
+      return !first_copy_received;
+    }
+
     void node_impl::fetch_sync_items_loop()
     {
       while( !_fetch_sync_items_loop_done.canceled() )
@@ -1055,6 +1211,7 @@ namespace graphene { namespace net {
           {
             ASSERT_TASK_NOT_PREEMPTED();
             std::set<item_hash_t> sync_items_to_request;
+            fc::time_point now = fc::time_point::now();
 
             // for each idle peer that we're syncing with
             for( const peer_connection_ptr& peer : _active_connections )
@@ -1065,21 +1222,36 @@ namespace graphene { namespace net {
               {
                 if (!peer->inhibit_fetching_sync_blocks)
                 {
+                  uint32_t window_size = std::min(peer->sync_window_size, _node_configuration.maximum_blocks_per_peer_during_syncing);
+                  // blocks before the first one nobody has been asked for are the ones holding up the backlog
+                  bool past_lowest_needed_items = false;
                   // loop through the items it has that we don't yet have on our blockchain
                   for( unsigned i = 0; i < peer->ids_of_items_to_get.size(); ++i )
                   {
                     item_hash_t item_to_potentially_request = peer->ids_of_items_to_get[i];
                     // if we don't already have this item in our temporary storage and we haven't requested from another syncing peer
-                    if( !have_already_received_sync_item(item_to_potentially_request) && // already got it, but for some reson it's still in our list of items to fetch
-                        sync_items_to_request.find(item_to_potentially_request) == sync_items_to_request.end() &&  // we have already decided to request it from another peer during this iteration
-                        _active_sync_requests.find(item_to_potentially_request) == _active_sync_requests.end() ) // we've requested it in a previous iteration and we're still waiting for it to arrive
+                    if( have_already_received_sync_item(item_to_potentially_request) || // already got it, but for some reson it's still in our list of items to fetch
+                        sync_items_to_request.find(item_to_potentially_request) != sync_items_to_request.end() ) // we have already decided to request it from another peer during this iteration
+                      continue;
+
+                    if( _active_sync_requests.find(item_to_potentially_request) == _active_sync_requests.end() )
+                      past_lowest_needed_items = true;
+                    else if( !past_lowest_needed_items && is_straggling_sync_request(item_to_potentially_request, now) )
                     {
-                      // then schedule a request from this peer
-                      sync_item_requests_to_send[peer].push_back(item_to_potentially_request);
-                      sync_items_to_request.insert( item_to_potentially_request );
-                      if (sync_item_requests_to_send[peer].size() >= _node_configuration.maximum_blocks_per_peer_during_syncing)
-                        break;
+                      // we requested it in a previous iteration and it's taking much longer than that peer
+                      // usually does.  ask this idle peer too, and keep whichever copy arrives first
+                      dlog( "sync item ${item_hash} is straggling, also requesting it from peer ${endpoint}",
+                            ("item_hash", item_to_potentially_request)("endpoint", peer->get_remote_endpoint()) );
+                      _duplicate_sync_requests[item_to_potentially_request] = false;
                     }
+                    else
+                      continue; // we're still waiting for it to arrive from another peer
+
+                    // then schedule a request from this peer
+                    sync_item_requests_to_send[peer].push_back(item_to_potentially_request);
+                    sync_items_to_request.insert( item_to_potentially_request );
+                    if (sync_item_requests_to_send[peer].size() >= window_size)
+                      break;
                   }
                 }
               }
@@ -1098,7 +1270,18 @@ namespace graphene { namespace net {
         {
           dlog( "no sync items to fetch right now, going to sleep" );
           _retrigger_fetch_sync_items_loop_promise = fc::promise<void>::ptr( new fc::promise<void>("graphene::net::retrigger_fetch_sync_items_loop") );
-          _retrigger_fetch_sync_items_loop_promise->wait();
+          // while blocks are outstanding, wake up now and then to look for stragglers
+          fc::microseconds time_until_retrigger = fc::microseconds::maximum();
+          if (!_active_sync_requests.empty())
+            time_until_retrigger = fc::milliseconds(GRAPHENE_NET_SYNC_STRAGGLER_MIN_DELAY_MILLISECONDS);
+          try
+          {
+            _retrigger_fetch_sync_items_loop_promise->wait(time_until_retrigger);
+          }
+          catch (const fc::timeout_exception&)
+          {
+            dlog("Resuming fetch_sync_items_loop to check for straggling sync requests");
+          }
           _retrigger_fetch_sync_items_loop_promise.reset();
         }
       } // while( !canceled )
@@ -1175,8 +1358,12 @@ namespace graphene { namespace net {
             for (auto peer_iter = items_by_peer.get<requested_item_count_index>().begin(); peer_iter != items_by_peer.get<requested_item_count_index>().end(); ++peer_iter)
             {
               const peer_connection_ptr& peer = peer_iter->peer;
+              // peers that can send transactions in batches are asked for many at once
+              size_t max_items_for_peer = GRAPHENE_NET_MAX_ITEMS_PER_PEER_DURING_NORMAL_OPERATION;
+              if (item_iter->item.item_type == graphene::net::trx_message_type && peer->supports_trx_batches)
+                max_items_for_peer = std::max<size_t>(max_items_for_peer, GRAPHENE_NET_MAX_TRX_PER_BATCH);
               // if they have the item and we haven't already decided to ask them for too many other items
-              if (peer_iter->item_ids.size() < GRAPHENE_NET_MAX_ITEMS_PER_PEER_DURING_NORMAL_OPERATION &&
+              if (peer_iter->item_ids.size() < max_items_for_peer &&
                   peer->inventory_peer_advertised_to_us.find(item_iter->item) != peer->inventory_peer_advertised_to_us.end())
               {
                 if (item_iter->item.item_type == graphene::net::trx_message_type && peer->is_transaction_fetching_inhibited())
@@ -1215,15 +1402,25 @@ namespace graphene { namespace net {
                  ("count", items_by_type.second.size())("type", (uint32_t)items_by_type.first)
                  ("endpoint", peer_and_items.peer->get_remote_endpoint())
                  ("hashes", items_by_type.second));
+            uint32_t item_type_to_request = items_by_type.first;
             if (items_by_type.first == core_message_type_enum::block_message_type)
+            {
               for (const item_hash_t& id : items_by_type.second)
               {
                 fc_dlog(fc::logger::get("sync"),
                         "requesting a block from peer ${endpoint} (message_id is ${id})",
                         ("endpoint", peer_and_items.peer->get_remote_endpoint())("id", id));
               }
+              // the block is still tracked as a block_message in items_requested_from_peer,
+              // only the reply the peer sends us changes
+              if (peer_and_items.peer->supports_compact_blocks)
+                item_type_to_request = core_message_type_enum::compact_block_message_type;
+            }
+            else if (items_by_type.first == core_message_type_enum::trx_message_type &&
+                     items_by_type.second.size() > 1 && peer_and_items.peer->supports_trx_batches)
+              item_type_to_request = core_message_type_enum::trx_batch_message_type;
 
-            peer_and_items.peer->send_message(fetch_items_message(items_by_type.first,
+            peer_and_items.peer->send_message(fetch_items_message(item_type_to_request,
                                                                   items_by_type.second));
           }
         }
@@ -1265,6 +1462,7 @@ namespace graphene { namespace net {
         // swap inventory into local variable, clearing the node's copy
         std::unordered_set<item_id> inventory_to_advertise;
         inventory_to_advertise.swap(_new_inventory);
+        _new_inventory_contains_block = false;
 
         // process all inventory to advertise and construct the inventory messages we'll send
         // first, then send them all in a batch (to avoid any fiber interruption points while
@@ -1321,12 +1519,33 @@ namespace graphene { namespace net {
           _retrigger_advertise_inventory_loop_promise->wait();
           _retrigger_advertise_inventory_loop_promise.reset();
         }
+
+        // give the rest of a burst of transactions a moment to arrive so they're all advertised
+        // in one inventory message per peer.  a new block ends the wait right away
+        if (_node_configuration.inventory_coalescing_milliseconds > 0 &&
+            !_new_inventory_contains_block && !_node_is_shutting_down)
+        {
+          _retrigger_advertise_inventory_loop_promise = fc::promise<void>::ptr(new fc::promise<void>("graphene::net::retrigger_advertise_inventory_loop"));
+          _coalescing_new_inventory = true;
+          try
+          {
+            _retrigger_advertise_inventory_loop_promise->wait(fc::milliseconds(_node_configuration.inventory_coalescing_milliseconds));
+          }
+          catch (const fc::timeout_exception&)
+          {
+          }
+          _coalescing_new_inventory = false;
+          _retrigger_advertise_inventory_loop_promise.reset();
+        }
       } // while(!canceled)
     }
 
     void node_impl::trigger_advertise_inventory_loop()
     {
       VERIFY_CORRECT_THREAD();
+      // while transactions are being collected, only a block (or shutting down) is worth waking up for
+      if( _coalescing_new_inventory && !_new_inventory_contains_block && !_node_is_shutting_down )
+        return;
       if( _retrigger_advertise_inventory_loop_promise )
         _retrigger_advertise_inventory_loop_promise->set_value();
     }
@@ -1606,6 +1825,7 @@ namespace graphene { namespace net {
         update_bandwidth_data(0, 0);
       update_bandwidth_data(bytes_read_this_second, bytes_written_this_second);
       _bandwidth_monitor_last_update_time = current_time;
+      publish_network_telemetry(bytes_read_this_second, bytes_written_this_second);
 
       if (!_node_is_shutting_down && !_bandwidth_monitor_loop_done.canceled())
         _bandwidth_monitor_loop_done = schedule_task( [=](){ bandwidth_monitor_loop(); },
@@ -1613,6 +1833,52 @@ namespace graphene { namespace net {
                                                      "bandwidth_monitor_loop" );
     }
 
+    void node_impl::publish_network_telemetry(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second)
+    {
+      VERIFY_CORRECT_THREAD();
+      std::shared_ptr<network_telemetry> telemetry = std::make_shared<network_telemetry>();
+      telemetry->snapshot_time = fc::time_point::now();
+      telemetry->upload_bytes_per_second = bytes_written_this_second;
+      telemetry->download_bytes_per_second = bytes_read_this_second;
+      if (!_average_network_write_speed_minutes.empty())
+      {
+        telemetry->upload_rate_one_minute = _average_network_write_speed_minutes.back();
+        telemetry->download_rate_one_minute = _average_network_read_speed_minutes.back();
+      }
+      telemetry->active_sync_requests = (uint32_t)_active_sync_requests.size();
+      telemetry->sync_backlog_size = (uint32_t)_received_sync_items.size();
+      telemetry->items_to_fetch = (uint32_t)_items_to_fetch.size();
+      if (_delegate)
+        telemetry->delegate_call_statistics = _delegate->get_call_statistics();
+
+      telemetry->peers.reserve(_active_connections.size());
+      for (const peer_connection_ptr& peer : _active_connections)
+      {
+        ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+        peer_telemetry peer_data;
+        peer_data.host = peer->get_remote_endpoint();
+        peer_data.node_id = peer->node_id;
+        peer_data.user_agent = peer->user_agent;
+        peer_data.connection_time = peer->get_connection_time();
+        peer_data.round_trip_delay = peer->round_trip_delay;
+        peer_data.clock_offset = peer->clock_offset;
+        peer_data.queued_message_bytes = peer->get_total_queued_messages_size();
+        peer_data.items_in_flight = (uint32_t)peer->items_requested_from_peer.size();
+        peer_data.sync_items_in_flight = (uint32_t)peer->sync_items_requested_from_peer.size();
+        peer_data.sync_items_to_get = (uint32_t)peer->ids_of_items_to_get.size();
+        peer_data.sync_window_size = peer->sync_window_size;
+        peer_data.sync_bytes_per_second = peer->sync_bytes_per_second;
+        peer_data.average_sync_item_latency = peer->average_sync_item_latency;
+        peer_data.bytes_sent = peer->get_total_bytes_sent();
+        peer_data.bytes_received = peer->get_total_bytes_received();
+        peer_data.we_need_sync_items_from_peer = peer->we_need_sync_items_from_peer;
+        peer_data.peer_needs_sync_items_from_us = peer->peer_needs_sync_items_from_us;
+        telemetry->peers.push_back(std::move(peer_data));
+      }
+
+      std::atomic_store(&_network_telemetry, std::shared_ptr<const network_telemetry>(std::move(telemetry)));
+    }
+
     void node_impl::dump_node_status_task()
     {
       dump_node_status();
@@ -1622,6 +1888,15 @@ namespace graphene { namespace net {
                                                    "dump_node_status_task");
     }
 
+    void node_impl::flush_peer_database_task()
+    {
+      _potential_peer_db.flush();
+      if (!_node_is_shutting_down && !_flush_peer_database_task_done.canceled())
+        _flush_peer_database_task_done = schedule_task([=](){ flush_peer_database_task(); },
+                                                       fc::time_point::now() + fc::seconds(GRAPHENE_NET_PEER_DATABASE_FLUSH_INTERVAL_SECONDS),
+                                                       "flush_peer_database_task");
+    }
+
     void node_impl::delayed_peer_deletion_task()
     {
 #ifdef USE_PEERS_TO_DELETE_MUTEX
@@ -1849,6 +2124,18 @@ namespace graphene { namespace net {
       case core_message_type_enum::get_current_connections_reply_message_type:
         on_get_current_connections_reply_message(originating_peer, received_message.as<get_current_connections_reply_message>());
         break;
+      case core_message_type_enum::compact_block_message_type:
+        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+        break;
+      case core_message_type_enum::fetch_block_transactions_message_type:
+        on_fetch_block_transactions_message(originating_peer, received_message.as<fetch_block_transactions_message>());
+        break;
+      case core_message_type_enum::block_transactions_message_type:
+        on_block_transactions_message(originating_peer, received_message.as<block_transactions_message>());
+        break;
+      case core_message_type_enum::trx_batch_message_type:
+        on_trx_batch_message(originating_peer, received_message.as<trx_batch_message>());
+        break;
 
       default:
         // ignore any message in between core_message_type_first and _last that we don't handle above
@@ -1893,6 +2180,8 @@ namespace graphene { namespace net {
         user_data["last_known_fork_block_number"] = _hard_fork_block_numbers.back();
 
       user_data["chain_id"] = _delegate->get_chain_id();
+      user_data["compact_blocks"] = true;
+      user_data["trx_batches"] = true;
 
       return user_data;
     }
@@ -1918,6 +2207,10 @@ namespace graphene { namespace net {
         originating_peer->last_known_fork_block_number = user_data["last_known_fork_block_number"].as<uint32_t>();
       if (user_data.contains("chain_id"))
         originating_peer->chain_id = user_data["chain_id"].as<morphene::protocol::chain_id_type>();
+      if (user_data.contains("compact_blocks"))
+        originating_peer->supports_compact_blocks = user_data["compact_blocks"].as<bool>();
+      if (user_data.contains("trx_batches"))
+        originating_peer->supports_trx_batches = user_data["trx_batches"].as<bool>();
     }
 
     void node_impl::on_hello_message( peer_connection* originating_peer, const hello_message& hello_message_received )
@@ -2778,7 +3071,7 @@ namespace graphene { namespace net {
 
       try
       {
-        return _message_cache.get_message(item.item_hash);
+        return *_message_cache.get_message(item.item_hash);
       }
       catch (fc::key_not_found_exception&)
       {}
@@ -2799,17 +3092,76 @@ namespace graphene { namespace net {
            ("type", fetch_items_message_received.item_type)
            ("endpoint", originating_peer->get_remote_endpoint()));
 
-      fc::optional<message> last_block_message_sent;
+      std::shared_ptr<const message> last_block_message_sent;
+
+      if (fetch_items_message_received.item_type == compact_block_message_type)
+      {
+        // compact blocks are only offered for blocks we relayed during normal operation, those
+        // are the ones still in our message cache.  Otherwise tell the peer we don't have the
+        // block and it will fetch the full block from someone else
+        for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
+        {
+          try
+          {
+            std::shared_ptr<const message> requested_message = _message_cache.get_message(item_hash);
+            if (requested_message->msg_type == block_message_type)
+            {
+              block_message full_block = requested_message->as<block_message>();
+              originating_peer->send_message(compact_block_message(item_hash, full_block));
+              last_block_message_sent = requested_message;
+              continue;
+            }
+          }
+          catch (fc::key_not_found_exception&)
+          {
+          }
+          originating_peer->send_message(item_not_available_message(item_id(block_message_type, item_hash)));
+        }
+        if (last_block_message_sent)
+        {
+          graphene::net::block_message block = last_block_message_sent->as<graphene::net::block_message>();
+          originating_peer->last_block_delegate_has_seen = block.block_id;
+          originating_peer->last_block_time_delegate_has_seen = block.block.timestamp;
+        }
+        return;
+      }
+
+      if (fetch_items_message_received.item_type == trx_batch_message_type)
+      {
+        // transactions are only relayed out of our message cache, same as in the single trx case
+        std::vector<message> transactions;
+        transactions.reserve(fetch_items_message_received.items_to_fetch.size());
+        for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
+        {
+          try
+          {
+            std::shared_ptr<const message> requested_message = _message_cache.get_message(item_hash);
+            if (requested_message->msg_type == trx_message_type)
+            {
+              transactions.push_back(*requested_message);
+              continue;
+            }
+          }
+          catch (fc::key_not_found_exception&)
+          {
+          }
+          originating_peer->send_message(item_not_available_message(item_id(trx_message_type, item_hash)));
+        }
+        // a hundred large transactions don't fit in one message, the peer accepts any number of batches
+        for (const trx_batch_message& batch : trx_batch_message::split(std::move(transactions)))
+          originating_peer->send_message(batch);
+        return;
+      }
 
-      std::list<message> reply_messages;
+      std::list<std::shared_ptr<const message> > reply_messages;
       for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
       {
         try
         {
-          message requested_message = _message_cache.get_message(item_hash);
+          std::shared_ptr<const message> requested_message = _message_cache.get_message(item_hash);
           dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                ("endpoint", originating_peer->get_remote_endpoint())
-               ("id", requested_message.id()));
+               ("id", item_hash));
           reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
             last_block_message_sent = requested_message;
@@ -2823,10 +3175,10 @@ namespace graphene { namespace net {
         item_id item_to_fetch(fetch_items_message_received.item_type, item_hash);
         try
         {
-          message requested_message = _delegate->get_item(item_to_fetch);
+          std::shared_ptr<const message> requested_message = std::make_shared<const message>(_delegate->get_item(item_to_fetch));
           dlog("received item request from peer ${endpoint}, returning the item from delegate with id ${id} size ${size}",
-               ("id", requested_message.id())
-               ("size", requested_message.size)
+               ("id", requested_message->id())
+               ("size", requested_message->size)
                ("endpoint", originating_peer->get_remote_endpoint()));
           reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
@@ -2835,7 +3187,7 @@ namespace graphene { namespace net {
         }
         catch (fc::key_not_found_exception&)
         {
-          reply_messages.push_back(item_not_available_message(item_to_fetch));
+          reply_messages.push_back(std::make_shared<const message>(item_not_available_message(item_to_fetch)));
           dlog("received item request from peer ${endpoint} but we don't have it",
                ("endpoint", originating_peer->get_remote_endpoint()));
         }
@@ -2849,15 +3201,168 @@ namespace graphene { namespace net {
         originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
       }
 
-      for (const message& reply : reply_messages)
+      for (const std::shared_ptr<const message>& reply : reply_messages)
       {
-        if (reply.msg_type == block_message_type)
-          originating_peer->send_item(item_id(block_message_type, reply.as<graphene::net::block_message>().block_id));
+        if (reply->msg_type == block_message_type)
+          originating_peer->send_item(item_id(block_message_type, reply->as<graphene::net::block_message>().block_id));
         else
-          originating_peer->send_message(reply);
+          originating_peer->send_message(*reply);
       }
     }
 
+    void node_impl::on_trx_batch_message(peer_connection* originating_peer, const trx_batch_message& trx_batch_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      dlog("received a batch of ${count} transactions from peer ${endpoint}",
+           ("count", trx_batch_message_received.transactions.size())("endpoint", originating_peer->get_remote_endpoint()));
+      // each transaction goes through the same path as if it had arrived in its own trx_message,
+      // which checks that we asked for it
+      for (const message& transaction_message : trx_batch_message_received.transactions)
+      {
+        if (transaction_message.msg_type != trx_message_type)
+        {
+          wlog("received a transaction batch containing a message of type ${type} from peer ${endpoint}, disconnecting from peer",
+               ("type", transaction_message.msg_type)("endpoint", originating_peer->get_remote_endpoint()));
+          disconnect_from_peer(originating_peer, "You sent me a transaction batch containing something other than transactions", true,
+                               fc::exception(FC_LOG_MESSAGE(error, "Non-transaction message of type ${type} in a transaction batch",
+                                                            ("type", transaction_message.msg_type))));
+          return;
+        }
+        if (originating_peer->we_have_requested_close)
+          return;
+        process_ordinary_message(originating_peer, transaction_message, transaction_message.id());
+      }
+    }
+
+    void node_impl::on_compact_block_message(peer_connection* originating_peer, const compact_block_message& compact_block_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = compact_block_message_received.block_message_hash;
+      if (originating_peer->items_requested_from_peer.find(item_id(block_message_type, block_message_hash)) == originating_peer->items_requested_from_peer.end())
+      {
+        dlog("received a compact block ${id} we didn't request from peer ${endpoint}, ignoring it",
+             ("id", compact_block_message_received.block_id)("endpoint", originating_peer->get_remote_endpoint()));
+        return;
+      }
+
+      peer_connection::partial_compact_block partial_block;
+      partial_block.compact_block = compact_block_message_received;
+      partial_block.transactions.reserve(compact_block_message_received.short_transaction_ids.size());
+
+      std::vector<uint32_t> missing_transaction_indexes;
+      for (uint64_t short_transaction_id : compact_block_message_received.short_transaction_ids)
+      {
+        partial_block.transactions.push_back(_message_cache.find_transaction_by_short_id(short_transaction_id));
+        if (!partial_block.transactions.back())
+          missing_transaction_indexes.push_back(partial_block.transactions.size() - 1);
+      }
+
+      dlog("received compact block ${id} with ${count} transactions from peer ${endpoint}, ${missing} missing locally",
+           ("id", compact_block_message_received.block_id)
+           ("count", partial_block.transactions.size())
+           ("missing", missing_transaction_indexes.size())
+           ("endpoint", originating_peer->get_remote_endpoint()));
+
+      if (missing_transaction_indexes.empty())
+      {
+        process_reconstructed_compact_block(originating_peer, partial_block);
+        return;
+      }
+
+      originating_peer->partial_compact_blocks[block_message_hash] = std::move(partial_block);
+      originating_peer->send_message(fetch_block_transactions_message(block_message_hash, std::move(missing_transaction_indexes)));
+    }
+
+    void node_impl::on_fetch_block_transactions_message(peer_connection* originating_peer, const fetch_block_transactions_message& fetch_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = fetch_block_transactions_message_received.block_message_hash;
+      block_message full_block;
+      try
+      {
+        std::shared_ptr<const message> requested_message = _message_cache.get_message(block_message_hash);
+        if (requested_message->msg_type != block_message_type)
+          FC_THROW_EXCEPTION(fc::key_not_found_exception, "Requested message is not a block");
+        full_block = requested_message->as<block_message>();
+      }
+      catch (fc::key_not_found_exception&)
+      {
+        // the block fell out of our cache since we sent the compact block
+        originating_peer->send_message(item_not_available_message(item_id(block_message_type, block_message_hash)));
+        return;
+      }
+
+      block_transactions_message reply(block_message_hash);
+      reply.transactions.reserve(fetch_block_transactions_message_received.transaction_indexes.size());
+      for (uint32_t transaction_index : fetch_block_transactions_message_received.transaction_indexes)
+      {
+        if (transaction_index >= full_block.block.transactions.size())
+        {
+          wlog("peer ${endpoint} asked for transaction ${index} of a block with ${count} transactions",
+               ("endpoint", originating_peer->get_remote_endpoint())
+               ("index", transaction_index)
+               ("count", full_block.block.transactions.size()));
+          originating_peer->send_message(item_not_available_message(item_id(block_message_type, block_message_hash)));
+          return;
+        }
+        reply.transactions.push_back(full_block.block.transactions[transaction_index]);
+      }
+      originating_peer->send_message(reply);
+    }
+
+    void node_impl::on_block_transactions_message(peer_connection* originating_peer, const block_transactions_message& block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      auto partial_block_iter = originating_peer->partial_compact_blocks.find(block_transactions_message_received.block_message_hash);
+      if (partial_block_iter == originating_peer->partial_compact_blocks.end())
+      {
+        dlog("received transactions for a compact block we aren't waiting on from peer ${endpoint}, ignoring them",
+             ("endpoint", originating_peer->get_remote_endpoint()));
+        return;
+      }
+
+      peer_connection::partial_compact_block partial_block = std::move(partial_block_iter->second);
+      originating_peer->partial_compact_blocks.erase(partial_block_iter);
+
+      auto next_transaction = block_transactions_message_received.transactions.begin();
+      for (fc::optional<signed_transaction>& trx : partial_block.transactions)
+        if (!trx && next_transaction != block_transactions_message_received.transactions.end())
+          trx = *next_transaction++;
+
+      process_reconstructed_compact_block(originating_peer, partial_block);
+    }
+
+    void node_impl::process_reconstructed_compact_block(peer_connection* originating_peer, const peer_connection::partial_compact_block& partial_block)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = partial_block.compact_block.block_message_hash;
+
+      fc::optional<message> reconstructed_message;
+      if (std::all_of(partial_block.transactions.begin(), partial_block.transactions.end(),
+                      [](const fc::optional<signed_transaction>& trx) { return trx.valid(); }))
+      {
+        block_message reconstructed_block;
+        static_cast<morphene::protocol::signed_block_header&>(reconstructed_block.block) = partial_block.compact_block.header;
+        reconstructed_block.block.transactions.reserve(partial_block.transactions.size());
+        for (const fc::optional<signed_transaction>& trx : partial_block.transactions)
+          reconstructed_block.block.transactions.push_back(*trx);
+        reconstructed_block.block_id = partial_block.compact_block.block_id;
+        reconstructed_message = message(reconstructed_block);
+      }
+
+      // the message hash covers the whole block, so a match means we rebuilt exactly the block
+      // the peer advertised.  A short id collision or a bad reply falls back to the full block
+      if (!reconstructed_message || reconstructed_message->id() != block_message_hash)
+      {
+        wlog("unable to reconstruct compact block ${id} from peer ${endpoint}, requesting the full block",
+             ("id", partial_block.compact_block.block_id)("endpoint", originating_peer->get_remote_endpoint()));
+        originating_peer->send_message(fetch_items_message(block_message_type, std::vector<item_hash_t>{block_message_hash}));
+        return;
+      }
+
+      process_block_message(originating_peer, *reconstructed_message, block_message_hash);
+    }
+
     void node_impl::on_item_not_available_message( peer_connection* originating_peer, const item_not_available_message& item_not_available_message_received )
     {
       VERIFY_CORRECT_THREAD();
@@ -2866,6 +3371,7 @@ namespace graphene { namespace net {
       if (regular_item_iter != originating_peer->items_requested_from_peer.end())
       {
         originating_peer->items_requested_from_peer.erase( regular_item_iter );
+        originating_peer->partial_compact_blocks.erase( requested_item.item_hash );
         originating_peer->inventory_peer_advertised_to_us.erase( requested_item );
         if (is_item_in_any_peers_inventory(requested_item))
           _items_to_fetch.insert(prioritized_item_id(requested_item, _items_to_fetch_sequence_counter++));
@@ -2878,6 +3384,7 @@ namespace graphene { namespace net {
       if (sync_item_iter != originating_peer->sync_items_requested_from_peer.end())
       {
         originating_peer->sync_items_requested_from_peer.erase(sync_item_iter);
+        forget_duplicate_sync_request(requested_item.item_hash);
 
         if (originating_peer->peer_needs_sync_items_from_us)
           originating_peer->inhibit_fetching_sync_blocks = true;
@@ -3074,7 +3581,8 @@ namespace graphene { namespace net {
       if (!originating_peer->sync_items_requested_from_peer.empty())
       {
         for (const auto& sync_item : originating_peer->sync_items_requested_from_peer)
-          _active_sync_requests.erase(sync_item);
+          if (!forget_duplicate_sync_request(sync_item))
+            _active_sync_requests.erase(sync_item);
         trigger_fetch_sync_items_loop();
       }
 
@@ -3324,86 +3832,91 @@ namespace graphene { namespace net {
       std::set<peer_connection_ptr> peers_we_need_to_sync_to;
       std::map<peer_connection_ptr, fc::oexception> peers_with_rejected_block;
 
+      auto& backlog_by_id = _received_sync_items.get<sync_block_id_index>();
+
       do
       {
-        std::copy(std::make_move_iterator(_new_received_sync_items.begin()),
-                  std::make_move_iterator(_new_received_sync_items.end()),
-                  std::front_inserter(_received_sync_items));
-        _new_received_sync_items.clear();
         dlog("currently ${count} sync items to consider", ("count", _received_sync_items.size()));
 
         block_processed_this_iteration = false;
-        for (auto received_block_iter = _received_sync_items.begin();
-             received_block_iter != _received_sync_items.end();
-             ++received_block_iter)
+
+        // a block can be processed when it is the next item we expect from at least one peer.  Look up
+        // each peer's next expected item in the backlog and take the lowest numbered one, so the backlog
+        // drains in chain order without being rescanned after every block
+        auto received_block_iter = backlog_by_id.end();
+        for (const peer_connection_ptr& peer : _active_connections)
         {
+          ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+          if (peer->ids_of_items_to_get.empty())
+            continue;
+          auto candidate_iter = backlog_by_id.find(peer->ids_of_items_to_get.front());
+          if (candidate_iter != backlog_by_id.end() &&
+              (received_block_iter == backlog_by_id.end() ||
+               candidate_iter->block.block_num() < received_block_iter->block.block_num()))
+            received_block_iter = candidate_iter;
+        }
 
-          // find out if this block is the next block on the active chain or one of the forks
-          bool potential_first_block = false;
+        // if we found one, process it and remove it from all sync peers lists
+        if (received_block_iter != backlog_by_id.end())
+        {
+          const block_id_type block_id = received_block_iter->block_id;
           for (const peer_connection_ptr& peer : _active_connections)
           {
             ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
             if (!peer->ids_of_items_to_get.empty() &&
-                peer->ids_of_items_to_get.front() == received_block_iter->block_id)
+                peer->ids_of_items_to_get.front() == block_id)
             {
-              potential_first_block = true;
               peer->ids_of_items_to_get.pop_front();
-              peer->ids_of_items_being_processed.insert(received_block_iter->block_id);
+              peer->ids_of_items_being_processed.insert(block_id);
             }
           }
 
-          // if it is, process it, remove it from all sync peers lists
-          if (potential_first_block)
+          // we can get into an interesting situation near the end of synchronization.  We can be in
+          // sync with one peer who is sending us the last block on the chain via a regular inventory
+          // message, while at the same time still be synchronizing with a peer who is sending us the
+          // block through the sync mechanism.  Further, we must request both blocks because
+          // we don't know they're the same (for the peer in normal operation, it has only told us the
+          // message id, for the peer in the sync case we only known the block_id).
+          if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
+                        block_id) == _most_recent_blocks_accepted.end())
           {
-            // we can get into an interesting situation near the end of synchronization.  We can be in
-            // sync with one peer who is sending us the last block on the chain via a regular inventory
-            // message, while at the same time still be synchronizing with a peer who is sending us the
-            // block through the sync mechanism.  Further, we must request both blocks because
-            // we don't know they're the same (for the peer in normal operation, it has only told us the
-            // message id, for the peer in the sync case we only known the block_id).
-            if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
-                          received_block_iter->block_id) == _most_recent_blocks_accepted.end())
-            {
-              graphene::net::block_message block_message_to_process = *received_block_iter;
-              _received_sync_items.erase(received_block_iter);
-              _handle_message_calls_in_progress.emplace_back(async_task([this, block_message_to_process](){
-                send_sync_block_to_node_delegate(block_message_to_process);
-              }, "send_sync_block_to_node_delegate"));
-              ++blocks_processed;
-              block_processed_this_iteration = true;
-            }
-            else
+            graphene::net::block_message block_message_to_process = *received_block_iter;
+            backlog_by_id.erase(received_block_iter);
+            _handle_message_calls_in_progress.emplace_back(async_task([this, block_message_to_process](){
+              send_sync_block_to_node_delegate(block_message_to_process);
+            }, "send_sync_block_to_node_delegate"));
+            ++blocks_processed;
+            block_processed_this_iteration = true;
+          }
+          else
+          {
+            dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
+            std::vector< peer_connection_ptr > peers_needing_next_batch;
+            for (const peer_connection_ptr& peer : _active_connections)
             {
-              dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
-              std::vector< peer_connection_ptr > peers_needing_next_batch;
-              for (const peer_connection_ptr& peer : _active_connections)
+              auto items_being_processed_iter = peer->ids_of_items_being_processed.find(block_id);
+              if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
               {
-                auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_iter->block_id);
-                if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
+                peer->ids_of_items_being_processed.erase(items_being_processed_iter);
+                dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
+                     ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
+
+                // if we just processed the last item in our list from this peer, we will want to
+                // send another request to find out if we are now in sync (this is normally handled in
+                // send_sync_block_to_node_delegate)
+                if (peer->ids_of_items_to_get.empty() &&
+                    peer->number_of_unfetched_item_ids == 0 &&
+                    peer->ids_of_items_being_processed.empty())
                 {
-                  peer->ids_of_items_being_processed.erase(items_being_processed_iter);
-                  dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
-                       ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
-
-                  // if we just processed the last item in our list from this peer, we will want to
-                  // send another request to find out if we are now in sync (this is normally handled in
-                  // send_sync_block_to_node_delegate)
-                  if (peer->ids_of_items_to_get.empty() &&
-                      peer->number_of_unfetched_item_ids == 0 &&
-                      peer->ids_of_items_being_processed.empty())
-                  {
-                    dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
-                    peers_needing_next_batch.push_back( peer );
-                  }
+                  dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
+                  peers_needing_next_batch.push_back( peer );
                 }
               }
-              for( const peer_connection_ptr& peer : peers_needing_next_batch )
-                fetch_next_batch_of_item_ids_from_peer(peer.get());
             }
-
-            break; // start iterating _received_sync_items from the beginning
-          } // end if potential_first_block
-        } // end for each block in _received_sync_items
+            for( const peer_connection_ptr& peer : peers_needing_next_batch )
+              fetch_next_batch_of_item_ids_from_peer(peer.get());
+          }
+        } // end if a block in the backlog is expected next
 
         if (_handle_message_calls_in_progress.size() >= _node_configuration.maximum_number_of_blocks_to_handle_at_one_time)
         {
@@ -3435,13 +3948,14 @@ namespace graphene { namespace net {
     {
       dlog( "received a sync block from peer ${endpoint}", ("endpoint", originating_peer->get_remote_endpoint() ) );
 
-      // add it to the front of _received_sync_items, then process _received_sync_items to try to
+      // add it to _received_sync_items, then process _received_sync_items to try to
       // pass as many messages as possible to the client.
-      _new_received_sync_items.push_front( block_message_to_process );
+      _received_sync_items.insert( block_message_to_process );
       trigger_process_backlog_of_sync_blocks();
     }
 
     void node_impl::process_block_during_normal_operation( peer_connection* originating_peer,
+                                                           const message& message_to_process,
                                                            const graphene::net::block_message& block_message_to_process,
                                                            const message_hash_type& message_hash )
     {
@@ -3530,7 +4044,7 @@ namespace graphene { namespace net {
           peer->clear_old_inventory();
         }
         message_propagation_data propagation_data{message_receive_time, message_validated_time, originating_peer->node_id};
-        broadcast( block_message_to_process, propagation_data );
+        broadcast( message_to_process, propagation_data, message_hash, block_message_to_process.block_id );
         _message_cache.block_accepted();
 
         if (is_hard_fork_block(block_number))
@@ -3616,7 +4130,7 @@ namespace graphene { namespace net {
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
         originating_peer->items_requested_from_peer.erase(item_iter);
-        process_block_during_normal_operation(originating_peer, block_message_to_process, message_hash);
+        process_block_during_normal_operation(originating_peer, message_to_process, block_message_to_process, message_hash);
         if (originating_peer->idle())
           trigger_fetch_items_loop();
         return;
@@ -3633,9 +4147,28 @@ namespace graphene { namespace net {
           // of the function so we can log if this ever happens.
           try
           {
-            originating_peer->last_sync_item_received_time = fc::time_point::now();
-            _active_sync_requests.erase(block_message_to_process.block_id);
-            process_block_during_sync(originating_peer, block_message_to_process, message_hash);
+            record_sync_item_received(originating_peer, block_message_to_process.block_id, message_to_process.size);
+
+            // if this was a straggler we asked two peers for, only the first copy is used
+            bool is_second_copy = false;
+            auto duplicate_iter = _duplicate_sync_requests.find(block_message_to_process.block_id);
+            if (duplicate_iter != _duplicate_sync_requests.end())
+            {
+              is_second_copy = duplicate_iter->second;
+              if (is_second_copy)
+                _duplicate_sync_requests.erase(duplicate_iter);
+              else
+                duplicate_iter->second = true;
+            }
+
+            if (!is_second_copy)
+            {
+              _active_sync_requests.erase(block_message_to_process.block_id);
+              process_block_during_sync(originating_peer, block_message_to_process, message_hash);
+            }
+            else
+              dlog("discarding second copy of straggling sync block ${block_id} from peer ${endpoint}",
+                   ("block_id", block_message_to_process.block_id)("endpoint", originating_peer->get_remote_endpoint()));
             if (originating_peer->idle())
             {
               // we have finished fetching a batch of items, so we either need to grab another batch of items
@@ -3701,6 +4234,22 @@ namespace graphene { namespace net {
                                                          (current_time_reply_message_received.reply_transmitted_time - reply_received_time)).count() / 2);
       originating_peer->round_trip_delay = (reply_received_time - current_time_reply_message_received.request_sent_time) -
                                            (current_time_reply_message_received.reply_transmitted_time - current_time_reply_message_received.request_received_time);
+
+      // remember how responsive the peer is so we prefer it when picking peers to connect to later
+      fc::optional<fc::ip::endpoint> inbound_endpoint = originating_peer->get_endpoint_for_connecting();
+      if (inbound_endpoint && originating_peer->round_trip_delay.count() > 0)
+      {
+        fc::optional<potential_peer_record> updated_peer_record = _potential_peer_db.lookup_entry_for_endpoint(*inbound_endpoint);
+        if (updated_peer_record)
+        {
+          if (updated_peer_record->average_round_trip_delay.count() == 0)
+            updated_peer_record->average_round_trip_delay = originating_peer->round_trip_delay;
+          else
+            updated_peer_record->average_round_trip_delay = fc::microseconds((updated_peer_record->average_round_trip_delay.count() * 7 +
+                                                                              originating_peer->round_trip_delay.count()) / 8);
+          _potential_peer_db.update_entry(*updated_peer_record);
+        }
+      }
     }
 
     void node_impl::forward_firewall_check_to_next_available_peer(firewall_check_state_data* firewall_check_state)
@@ -3971,12 +4520,14 @@ namespace graphene { namespace net {
 
         // Next: have the delegate process the message
         fc::time_point message_validated_time;
+        fc::uint160_t hash_of_message_contents;
         try
         {
           if (message_to_process.msg_type == trx_message_type)
           {
             trx_message transaction_message_to_process = message_to_process.as<trx_message>();
-            dlog("passing message containing transaction ${trx} to client", ("trx", transaction_message_to_process.trx.id()));
+            hash_of_message_contents = transaction_message_to_process.trx.id();
+            dlog("passing message containing transaction ${trx} to client", ("trx", hash_of_message_contents));
             _delegate->handle_transaction(transaction_message_to_process);
           }
           else
@@ -3997,7 +4548,7 @@ namespace graphene { namespace net {
 
         // finally, if the delegate validated the message, broadcast it to our other peers
         message_propagation_data propagation_data{message_receive_time, message_validated_time, originating_peer->node_id};
-        broadcast( message_to_process, propagation_data );
+        broadcast( message_to_process, propagation_data, message_hash, hash_of_message_contents );
       }
     }
 
@@ -4337,6 +4888,30 @@ namespace graphene { namespace net {
       {
         wlog( "Exception thrown while terminating Dump node status task, ignoring" );
       }
+
+      try
+      {
+        _flush_peer_database_task_done.cancel_and_wait("node_impl::close()");
+        dlog("Flush peer database task terminated");
+      }
+      catch ( const fc::exception& e )
+      {
+        wlog( "Exception thrown while terminating Flush peer database task, ignoring: ${e}", ("e", e) );
+      }
+      catch (...)
+      {
+        wlog( "Exception thrown while terminating Flush peer database task, ignoring" );
+      }
+
+      try
+      {
+        if (_node_configuration_saved.valid())
+          _node_configuration_saved.wait();
+      }
+      catch ( const fc::exception& e )
+      {
+        wlog( "Exception thrown while saving node configuration, ignoring: ${e}", ("e", e) );
+      }
     } // node_impl::close()
 
     void node_impl::accept_connection_task( peer_connection_ptr new_peer )
@@ -4589,7 +5164,7 @@ namespace graphene { namespace net {
       fc::path potential_peer_database_file_name(_node_configuration_directory / POTENTIAL_PEER_DATABASE_FILENAME);
       try
       {
-        _potential_peer_db.open(potential_peer_database_file_name);
+        _potential_peer_db.open(potential_peer_database_file_name, _file_io_thread.get());
 
         // push back the time on all peers loaded from the database so we will be able to retry them immediately
         for (peer_database::iterator itr = _potential_peer_db.begin(); itr != _potential_peer_db.end(); ++itr)
@@ -4717,7 +5292,8 @@ namespace graphene { namespace net {
              !_terminate_inactive_connections_loop_done.valid() &&
              !_fetch_updated_peer_lists_loop_done.valid() &&
              !_bandwidth_monitor_loop_done.valid() &&
-             !_dump_node_status_task_done.valid());
+             !_dump_node_status_task_done.valid() &&
+             !_flush_peer_database_task_done.valid());
       if (_node_configuration.accept_incoming_connections)
         _accept_loop_complete = async_task( [=](){ accept_loop(); }, "accept_loop");
       _p2p_network_connect_loop_done = async_task( [=]() { p2p_network_connect_loop(); }, "p2p_network_connect_loop" );
@@ -4728,6 +5304,9 @@ namespace graphene { namespace net {
       _fetch_updated_peer_lists_loop_done = async_task([=](){ fetch_updated_peer_lists_loop(); }, "fetch_updated_peer_lists_loop");
       _bandwidth_monitor_loop_done = async_task([=](){ bandwidth_monitor_loop(); }, "bandwidth_monitor_loop");
       _dump_node_status_task_done = async_task([=](){ dump_node_status_task(); }, "dump_node_status_task");
+      _flush_peer_database_task_done = schedule_task([=](){ flush_peer_database_task(); },
+                                                     fc::time_point::now() + fc::seconds(GRAPHENE_NET_PEER_DATABASE_FLUSH_INTERVAL_SECONDS),
+                                                     "flush_peer_database_task");
     }
 
     void node_impl::add_node(const fc::ip::endpoint& ep)
@@ -4866,8 +5445,14 @@ namespace graphene { namespace net {
 
       ilog( "--------- MEMORY USAGE ------------" );
       ilog( "node._active_sync_requests size: ${size}", ("size", _active_sync_requests.size() ) );
+      ilog( "node._duplicate_sync_requests size: ${size}", ("size", _duplicate_sync_requests.size() ) );
       ilog( "node._received_sync_items size: ${size}", ("size", _received_sync_items.size() ) );
-      ilog( "node._new_received_sync_items size: ${size}", ("size", _new_received_sync_items.size() ) );
+      if( !_received_sync_items.empty() )
+      {
+        const auto& backlog_by_number = _received_sync_items.get<sync_block_number_index>();
+        ilog( "node._received_sync_items blocks: ${first} to ${last}",
+              ("first", backlog_by_number.begin()->block.block_num())("last", backlog_by_number.rbegin()->block.block_num()) );
+      }
       ilog( "node._items_to_fetch size: ${size}", ("size", _items_to_fetch.size() ) );
       ilog( "node._new_inventory size: ${size}", ("size", _new_inventory.size() ) );
       ilog( "node._message_cache size: ${size}", ("size", _message_cache.size() ) );
@@ -4879,6 +5464,8 @@ namespace graphene { namespace net {
         ilog( "    peer.inventory_advertised_to_peer size: ${size}", ("size", peer->inventory_advertised_to_peer.size() ) );
         ilog( "    peer.items_requested_from_peer size: ${size}", ("size", peer->items_requested_from_peer.size() ) );
         ilog( "    peer.sync_items_requested_from_peer size: ${size}", ("size", peer->sync_items_requested_from_peer.size() ) );
+        ilog( "    peer.sync_window_size: ${size}, ${rate} bytes/s, ${latency} us latency",
+              ("size", peer->sync_window_size)("rate", peer->sync_bytes_per_second)("latency", peer->average_sync_item_latency.count() ) );
       }
       ilog( "--------- END MEMORY USAGE ------------" );
     }
@@ -5050,7 +5637,6 @@ namespace graphene { namespace net {
       {
         graphene::net::block_message block_message_to_broadcast = item_to_broadcast.as<graphene::net::block_message>();
         hash_of_message_contents = block_message_to_broadcast.block_id; // for debugging
-        _most_recent_blocks_accepted.push_back( block_message_to_broadcast.block_id );
       }
       else if( item_to_broadcast.msg_type == graphene::net::trx_message_type )
       {
@@ -5060,8 +5646,23 @@ namespace graphene { namespace net {
       }
       message_hash_type hash_of_item_to_broadcast = item_to_broadcast.id();
 
+      broadcast( item_to_broadcast, propagation_data, hash_of_item_to_broadcast, hash_of_message_contents );
+    }
+
+    // used for messages we received from a peer, which were already hashed and unpacked when we
+    // processed them.  The message is cached exactly as it came off the wire instead of being
+    // repacked from the unpacked item
+    void node_impl::broadcast( const message& item_to_broadcast, const message_propagation_data& propagation_data,
+                               const message_hash_type& hash_of_item_to_broadcast, const fc::uint160_t& hash_of_message_contents )
+    {
+      VERIFY_CORRECT_THREAD();
+      if( item_to_broadcast.msg_type == graphene::net::block_message_type )
+        _most_recent_blocks_accepted.push_back( hash_of_message_contents );
+
       _message_cache.cache_message( item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents );
       _new_inventory.insert( item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast ) );
+      if( item_to_broadcast.msg_type == graphene::net::block_message_type )
+        _new_inventory_contains_block = true;
       trigger_advertise_inventory_loop();
     }
 
@@ -5406,6 +6007,12 @@ namespace graphene { namespace net {
     INVOKE_IN_IMPL(get_call_statistics);
   }
 
+  std::shared_ptr<const network_telemetry> node::get_network_telemetry() const
+  {
+    // the snapshot is swapped atomically, so this doesn't need to run on the p2p thread
+    return std::atomic_load(&my->_network_telemetry);
+  }
+
   fc::variant_object node::network_get_info() const
   {
     INVOKE_IN_IMPL(network_get_info);
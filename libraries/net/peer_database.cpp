@@ -30,12 +30,40 @@
 
 #include <fc/io/raw.hpp>
 #include <fc/io/raw_variant.hpp>
+#include <fc/io/fstream.hpp>
 #include <fc/log/logger.hpp>
 #include <fc/io/json.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <graphene/net/peer_database.hpp>
 #include <graphene/net/config.hpp>
 
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <unordered_set>
+
+namespace graphene { namespace net { namespace detail {
+  /// written at the start of the on-disk log, the version changes whenever the record layout does
+  struct peer_database_file_header
+  {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+  };
+  const uint32_t peer_database_magic = 0x42445050; /// "PPDB"
+  const uint32_t peer_database_version = 1;
+
+  /// one record of the on-disk log, for an erase only the record's endpoint is meaningful
+  struct peer_database_log_entry
+  {
+    bool                  erased = false;
+    potential_peer_record record;
+  };
+} } } // end namespace graphene::net::detail
+
+FC_REFLECT( graphene::net::detail::peer_database_file_header, (magic)(version) )
+FC_REFLECT( graphene::net::detail::peer_database_log_entry, (erased)(record) )
+
 namespace graphene { namespace net {
   namespace detail
   {
@@ -61,10 +89,23 @@ namespace graphene { namespace net {
       potential_peer_set     _potential_peer_set;
       fc::path _peer_database_filename;
 
+      fc::thread*                          _io_thread = nullptr;
+      fc::future<void>                     _last_write;
+      std::unordered_set<fc::ip::endpoint> _dirty_endpoints; /// changed since the last flush
+      bool                                 _rewrite_needed = false;
+      uint32_t                             _log_entries_in_file = 0;
+      /// set by a failed write, possibly on the io thread, so the next write replaces the file
+      std::shared_ptr<std::atomic<bool>>   _write_failed = std::make_shared<std::atomic<bool>>(false);
+
+      void load_log(const fc::path& log_filename);
+      void load_legacy_json(const fc::path& json_filename);
+      void write_changes(bool rewrite);
+
     public:
-      void open(const fc::path& databaseFilename);
+      void open(const fc::path& databaseFilename, fc::thread* io_thread);
       void close();
       void clear();
+      void flush();
       void erase(const fc::ip::endpoint& endpointToErase);
       void update_entry(const potential_peer_record& updatedRecord);
       potential_peer_record lookup_or_create_entry_for_endpoint(const fc::ip::endpoint& endpointToLookup);
@@ -87,63 +128,208 @@ namespace graphene { namespace net {
     peer_database_iterator::peer_database_iterator( const peer_database_iterator& c ) :
       boost::iterator_facade<peer_database_iterator, const potential_peer_record, boost::forward_traversal_tag>(c){}
 
-    void peer_database_impl::open(const fc::path& peer_database_filename)
+    void peer_database_impl::load_log(const fc::path& log_filename)
     {
-      _peer_database_filename = peer_database_filename;
-      if (fc::exists(_peer_database_filename))
+      std::string log_contents;
+      fc::read_file_contents(log_filename, log_contents);
+      fc::datastream<const char*> ds(log_contents.data(), log_contents.size());
+
+      // a file from another version would mis-parse, it is dropped instead of being read as a torn log
+      peer_database_file_header header;
+      if (log_contents.size() >= fc::raw::pack_size(header))
+        fc::raw::unpack(ds, header);
+      if (header.magic != peer_database_magic || header.version != peer_database_version)
       {
-        try
+        wlog("peer database file ${peer_database_filename} has version ${v}, expected ${expected}, starting with a clean database",
+             ("peer_database_filename", log_filename)
+             ("v", header.magic == peer_database_magic ? fc::variant(header.version) : fc::variant("unknown"))
+             ("expected", peer_database_version));
+        _rewrite_needed = true;
+        return;
+      }
+
+      try
+      {
+        while (ds.remaining())
         {
-          std::vector<potential_peer_record> peer_records = fc::json::from_file(_peer_database_filename).as<std::vector<potential_peer_record> >();
-          std::copy(peer_records.begin(), peer_records.end(), std::inserter(_potential_peer_set, _potential_peer_set.end()));
-
-          if (_potential_peer_set.size() > GRAPHENE_NET_MAX_PEERDB_SIZE)
-          {
-            // prune database to a reasonable size
-            auto iter = _potential_peer_set.begin();
-            std::advance(iter, GRAPHENE_NET_MAX_PEERDB_SIZE);
-            _potential_peer_set.erase(iter, _potential_peer_set.end());
-          }
+          peer_database_log_entry entry;
+          fc::raw::unpack(ds, entry);
+          ++_log_entries_in_file;
+          if (entry.erased)
+            _potential_peer_set.get<endpoint_index>().erase(entry.record.endpoint);
+          else
+            update_entry(entry.record);
         }
-        catch (const fc::exception& e)
+      }
+      catch (const fc::exception& e)
+      {
+        // most likely a write that was cut short, everything before it is still good
+        wlog("ignoring the unreadable end of peer database file ${peer_database_filename}",
+             ("peer_database_filename", log_filename));
+        _rewrite_needed = true;
+      }
+    }
+
+    void peer_database_impl::load_legacy_json(const fc::path& json_filename)
+    {
+      std::vector<potential_peer_record> peer_records = fc::json::from_file(json_filename).as<std::vector<potential_peer_record> >();
+      std::copy(peer_records.begin(), peer_records.end(), std::inserter(_potential_peer_set, _potential_peer_set.end()));
+      _rewrite_needed = true;
+    }
+
+    void peer_database_impl::open(const fc::path& peer_database_filename, fc::thread* io_thread)
+    {
+      _peer_database_filename = peer_database_filename;
+      _io_thread = io_thread;
+      _log_entries_in_file = 0;
+
+      fc::path legacy_filename = _peer_database_filename;
+      legacy_filename.replace_extension(".json");
+
+      try
+      {
+        if (fc::exists(_peer_database_filename))
+          load_log(_peer_database_filename);
+        else if (legacy_filename != _peer_database_filename && fc::exists(legacy_filename))
+          load_legacy_json(legacy_filename);
+        else
+          _rewrite_needed = true; // only a rewrite writes the file header
+
+        if (_potential_peer_set.size() > GRAPHENE_NET_MAX_PEERDB_SIZE)
         {
-          elog("error opening peer database file ${peer_database_filename}, starting with a clean database", 
-               ("peer_database_filename", _peer_database_filename));
+          // prune database to a reasonable size
+          auto iter = _potential_peer_set.begin();
+          std::advance(iter, GRAPHENE_NET_MAX_PEERDB_SIZE);
+          _potential_peer_set.erase(iter, _potential_peer_set.end());
+          _rewrite_needed = true;
         }
       }
+      catch (const fc::exception& e)
+      {
+        elog("error opening peer database file ${peer_database_filename}, starting with a clean database", 
+             ("peer_database_filename", _peer_database_filename));
+        _potential_peer_set.clear();
+        _rewrite_needed = true;
+      }
+      _dirty_endpoints.clear();
     }
 
-    void peer_database_impl::close()
+    /// @return false if the file could not be written
+    bool write_peer_database_file(const fc::path& filename, const std::vector<char>& data, bool rewrite)
     {
-      std::vector<potential_peer_record> peer_records;
-      peer_records.reserve(_potential_peer_set.size());
-      std::copy(_potential_peer_set.begin(), _potential_peer_set.end(), std::back_inserter(peer_records));
-
       try
       {
-        fc::path peer_database_filename_dir = _peer_database_filename.parent_path();
+        fc::path peer_database_filename_dir = filename.parent_path();
         if (!fc::exists(peer_database_filename_dir))
           fc::create_directories(peer_database_filename_dir);
-        fc::json::save_to_file(peer_records, _peer_database_filename);
+
+        // a full rewrite goes to a temporary file first so a crash can't leave us with half a database
+        fc::path target_filename = rewrite ? fc::path(filename.string() + ".tmp") : filename;
+
+        std::ofstream out(target_filename.to_native_ansi_path(), std::ios::binary | (rewrite ? std::ios::trunc : std::ios::app));
+        out.write(data.data(), data.size());
+        out.close();
+        FC_ASSERT(out, "error writing peer database file");
+
+        if (rewrite)
+          fc::rename(target_filename, filename);
+        return true;
       }
       catch (const fc::exception& e)
       {
-        elog("error saving peer database to file ${peer_database_filename}", 
-             ("peer_database_filename", _peer_database_filename));
+        elog("error saving peer database to file ${peer_database_filename}: ${e}", 
+             ("peer_database_filename", filename)("e", e.to_detail_string()));
       }
+      return false;
+    }
+
+    void peer_database_impl::write_changes(bool rewrite)
+    {
+      // After a failed write the file may be missing, lack its header or end in a partial record,
+      // so it is replaced rather than appended to.  The log is also replaced once it holds more
+      // than twice as many records as are live, plus GRAPHENE_NET_MAX_PEERDB_SIZE of slack so a
+      // small database isn't rewritten on nearly every flush
+      bool write_failed = _write_failed->exchange(false);
+      rewrite = rewrite || _rewrite_needed || write_failed ||
+                _log_entries_in_file > 2 * _potential_peer_set.size() + GRAPHENE_NET_MAX_PEERDB_SIZE;
+      if (!rewrite && _dirty_endpoints.empty())
+        return;
+
+      std::vector<peer_database_log_entry> entries;
+      if (rewrite)
+      {
+        entries.reserve(_potential_peer_set.size());
+        for (const potential_peer_record& record : _potential_peer_set)
+          entries.push_back(peer_database_log_entry{false, record});
+      }
+      else
+      {
+        entries.reserve(_dirty_endpoints.size());
+        for (const fc::ip::endpoint& endpoint : _dirty_endpoints)
+        {
+          auto iter = _potential_peer_set.get<endpoint_index>().find(endpoint);
+          if (iter != _potential_peer_set.get<endpoint_index>().end())
+            entries.push_back(peer_database_log_entry{false, *iter});
+          else
+            entries.push_back(peer_database_log_entry{true, potential_peer_record(endpoint)});
+        }
+      }
+      _dirty_endpoints.clear();
+      _rewrite_needed = false;
+      _log_entries_in_file = rewrite ? entries.size() : _log_entries_in_file + entries.size();
+
+      peer_database_file_header header;
+      header.magic = peer_database_magic;
+      header.version = peer_database_version;
+
+      size_t packed_size = rewrite ? fc::raw::pack_size(header) : 0;
+      for (const peer_database_log_entry& entry : entries)
+        packed_size += fc::raw::pack_size(entry);
+      std::vector<char> data(packed_size);
+      fc::datastream<char*> ds(data.data(), data.size());
+      if (rewrite)
+        fc::raw::pack(ds, header);
+      for (const peer_database_log_entry& entry : entries)
+        fc::raw::pack(ds, entry);
+
+      if (_io_thread)
+        _last_write = _io_thread->async([filename = _peer_database_filename, data = std::move(data), rewrite, write_failed = _write_failed]() {
+          if (!write_peer_database_file(filename, data, rewrite))
+            *write_failed = true;
+        }, "peer_database write");
+      else if (!write_peer_database_file(_peer_database_filename, data, rewrite))
+        *_write_failed = true;
+    }
+
+    void peer_database_impl::flush()
+    {
+      write_changes(false);
+    }
+
+    void peer_database_impl::close()
+    {
+      write_changes(true);
+      if (_last_write.valid())
+        _last_write.wait();
+      _last_write = fc::future<void>();
       _potential_peer_set.clear();
     }
 
     void peer_database_impl::clear()
     {
       _potential_peer_set.clear();
+      _dirty_endpoints.clear();
+      _rewrite_needed = true;
     }
 
     void peer_database_impl::erase(const fc::ip::endpoint& endpointToErase)
     {
       auto iter = _potential_peer_set.get<endpoint_index>().find(endpointToErase);
       if (iter != _potential_peer_set.get<endpoint_index>().end())
+      {
         _potential_peer_set.get<endpoint_index>().erase(iter);
+        _dirty_endpoints.insert(endpointToErase);
+      }
     }
 
     void peer_database_impl::update_entry(const potential_peer_record& updatedRecord)
@@ -153,6 +339,7 @@ namespace graphene { namespace net {
         _potential_peer_set.get<endpoint_index>().modify(iter, [&updatedRecord](potential_peer_record& record) { record = updatedRecord; });
       else
         _potential_peer_set.get<endpoint_index>().insert(updatedRecord);
+      _dirty_endpoints.insert(updatedRecord.endpoint);
     }
 
     potential_peer_record peer_database_impl::lookup_or_create_entry_for_endpoint(const fc::ip::endpoint& endpointToLookup)
@@ -224,9 +411,9 @@ namespace graphene { namespace net {
   peer_database::~peer_database()
   {}
 
-  void peer_database::open(const fc::path& databaseFilename)
+  void peer_database::open(const fc::path& databaseFilename, fc::thread* io_thread)
   {
-    my->open(databaseFilename);
+    my->open(databaseFilename, io_thread);
   }
 
   void peer_database::close()
@@ -239,6 +426,11 @@ namespace graphene { namespace net {
     my->clear();
   }
 
+  void peer_database::flush()
+  {
+    my->flush();
+  }
+
   void peer_database::erase(const fc::ip::endpoint& endpointToErase)
   {
     my->erase(endpointToErase);
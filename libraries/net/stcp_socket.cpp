@@ -24,6 +24,9 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <vector>
 
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/aes.hpp>
@@ -32,14 +35,34 @@
 #include <fc/network/ip.hpp>
 #include <fc/exception/exception.hpp>
 
+#include <graphene/net/config.hpp>
 #include <graphene/net/stcp_socket.hpp>
 
 namespace graphene { namespace net {
 
+namespace detail {
+  // bulk AES work for all stcp sockets is shared among these threads, each socket
+  // sticks to the one it was assigned when it was created.  They are never destroyed,
+  // quitting them during static destruction would race with the fc thread state they use
+  fc::thread* next_crypto_thread()
+  {
+    static std::vector<fc::thread*>* crypto_threads = []()
+    {
+      std::vector<fc::thread*>* threads = new std::vector<fc::thread*>();
+      for (unsigned i = 0; i < GRAPHENE_NET_STCP_CRYPTO_THREADS; ++i)
+        threads->push_back(new fc::thread("stcp_crypto_" + std::to_string(i)));
+      return threads;
+    }();
+    static std::atomic<uint32_t> next_thread(0);
+    return (*crypto_threads)[next_thread++ % crypto_threads->size()];
+  }
+} // namespace detail
+
 stcp_socket::stcp_socket()
 //:_buf_len(0)
+   : _crypto_thread(detail::next_crypto_thread())
 #ifndef NDEBUG
-   : _read_buffer_in_use(false),
+   , _read_buffer_in_use(false),
      _write_buffer_in_use(false)
 #endif
 {
@@ -69,6 +92,50 @@ void stcp_socket::do_key_exchange()
 }
 
 
+/**
+ *  Runs crypto_task on this socket's crypto thread if there is enough data
+ *  to be worth it, yielding the calling fc thread until it completes.
+ */
+template<typename Functor>
+void stcp_socket::run_crypto_task( size_t len, Functor&& crypto_task )
+{
+  if( len < GRAPHENE_NET_STCP_CRYPTO_OFFLOAD_THRESHOLD )
+  {
+    crypto_task();
+    return;
+  }
+
+  fc::future<void> crypto_done = _crypto_thread->async( std::forward<Functor>(crypto_task), "stcp_socket crypto" );
+  std::exception_ptr canceled;
+  try
+  {
+    crypto_done.wait();
+  }
+  catch( const fc::canceled_exception& )
+  {
+    canceled = std::current_exception();
+  }
+
+  if( canceled )
+  {
+    // the task still uses buffers owned by our caller, they can't be released before it finishes.
+    // A canceled task can still block on the future, each wait lets the rest of this thread run
+    // until the crypto task is done and then throws canceled_exception again.  fc can't switch
+    // tasks inside a catch block, so this waits outside of it
+    while( !crypto_done.ready() )
+    {
+      try
+      {
+        crypto_done.wait();
+      }
+      catch( ... )
+      {
+      }
+    }
+    std::rethrow_exception( canceled );
+  }
+}
+
 void stcp_socket::connect_to( const fc::ip::endpoint& remote_endpoint )
 {
   _sock.connect_to( remote_endpoint );
@@ -100,7 +167,7 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
     } buffer_in_use_checker(_read_buffer_in_use);
 #endif
 
-    const size_t read_buffer_length = 4096;
+    const size_t read_buffer_length = GRAPHENE_NET_STCP_BUFFER_SIZE;
     if (!_read_buffer)
       _read_buffer.reset(new char[read_buffer_length], [](char* p){ delete[] p; });
 
@@ -112,7 +179,7 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
       _sock.read(_read_buffer, 16 - (s%16), s);
       s += 16-(s%16);
     }
-    _recv_aes.decode( _read_buffer.get(), s, buffer );
+    run_crypto_task( s, [&]() { _recv_aes.decode( _read_buffer.get(), s, buffer ); } );
     return s;
 } FC_RETHROW_EXCEPTIONS( warn, "", ("len",len) ) }
 
@@ -141,18 +208,14 @@ size_t stcp_socket::writesome( const char* buffer, size_t len )
     } buffer_in_use_checker(_write_buffer_in_use);
 #endif
 
-    const std::size_t write_buffer_length = 4096;
+    const std::size_t write_buffer_length = GRAPHENE_NET_STCP_BUFFER_SIZE;
     if (!_write_buffer)
       _write_buffer.reset(new char[write_buffer_length], [](char* p){ delete[] p; });
     len = std::min<size_t>(write_buffer_length, len);
-    memset(_write_buffer.get(), 0, len); // just in case aes.encode screws up
-    /**
-     * every sizeof(crypt_buf) bytes the aes channel
-     * has an error and doesn't decrypt properly...  disable
-     * for now because we are going to upgrade to something
-     * better.
-     */
-    uint32_t ciphertext_len = _send_aes.encode( buffer, len, _write_buffer.get() );
+    // encode the whole chunk in one call, AES with no padding writes exactly len bytes
+    // so the buffer doesn't need clearing first
+    uint32_t ciphertext_len = 0;
+    run_crypto_task( len, [&]() { ciphertext_len = _send_aes.encode( buffer, len, _write_buffer.get() ); } );
     assert(ciphertext_len == len);
     _sock.write( _write_buffer, ciphertext_len );
     return ciphertext_len;
@@ -0,0 +1,97 @@
+#define BOOST_TEST_MODULE net test
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/core_messages.hpp>
+
+#include <morphene/protocol/morphene_operations.hpp>
+
+using namespace graphene::net;
+using namespace morphene::protocol;
+
+// A transaction that packs to about json_size bytes
+static message make_trx_message( uint32_t n, size_t json_size )
+{
+   account_update_operation op;
+   op.account = "alice";
+   op.json_metadata = std::string( json_size, 'a' + n % 26 );
+
+   signed_transaction trx;
+   trx.ref_block_num = n;
+   trx.operations.push_back( op );
+   return message( trx_message( trx ) );
+}
+
+static std::vector< message > make_trx_messages( uint32_t count, size_t json_size )
+{
+   std::vector< message > transactions;
+   for( uint32_t n = 0; n < count; ++n )
+      transactions.push_back( make_trx_message( n, json_size ) );
+   return transactions;
+}
+
+// Checks that the batches fit in a message and hold the transactions in their original order
+static void check_batches( const std::vector< message >& transactions, const std::vector< trx_batch_message >& batches )
+{
+   size_t next = 0;
+   for( const trx_batch_message& batch : batches )
+   {
+      BOOST_REQUIRE( !batch.transactions.empty() );
+      message batch_message( batch );
+      BOOST_CHECK_LE( batch_message.size, MAX_MESSAGE_SIZE );
+
+      auto received = batch_message.as< trx_batch_message >();
+      BOOST_REQUIRE_EQUAL( received.transactions.size(), batch.transactions.size() );
+      for( const message& transaction : received.transactions )
+      {
+         BOOST_REQUIRE_LT( next, transactions.size() );
+         BOOST_CHECK( transaction.id() == transactions[ next ].id() );
+         ++next;
+      }
+   }
+   BOOST_CHECK_EQUAL( next, transactions.size() );
+}
+
+BOOST_AUTO_TEST_SUITE( trx_batch_tests )
+
+BOOST_AUTO_TEST_CASE( small_transactions_share_one_batch )
+{
+   auto transactions = make_trx_messages( GRAPHENE_NET_MAX_TRX_PER_BATCH, 200 );
+   auto batches = trx_batch_message::split( transactions );
+   BOOST_CHECK_EQUAL( batches.size(), 1u );
+   check_batches( transactions, batches );
+}
+
+BOOST_AUTO_TEST_CASE( oversized_transactions_are_split )
+{
+   // a full batch of the largest transactions is several times MAX_MESSAGE_SIZE
+   auto transactions = make_trx_messages( GRAPHENE_NET_MAX_TRX_PER_BATCH, MORPHENE_MAX_TRANSACTION_SIZE - 200 );
+   BOOST_REQUIRE_GT( message( trx_batch_message{ transactions } ).size, MAX_MESSAGE_SIZE );
+
+   auto batches = trx_batch_message::split( transactions );
+   BOOST_CHECK_GT( batches.size(), 3u );
+   check_batches( transactions, batches );
+}
+
+BOOST_AUTO_TEST_CASE( transaction_larger_than_a_message_is_sent_alone )
+{
+   std::vector< message > transactions;
+   transactions.push_back( make_trx_message( 0, 100 ) );
+   transactions.push_back( make_trx_message( 1, MAX_MESSAGE_SIZE ) );
+   transactions.push_back( make_trx_message( 2, 100 ) );
+
+   auto batches = trx_batch_message::split( transactions );
+   BOOST_REQUIRE_EQUAL( batches.size(), 3u );
+   for( size_t i = 0; i < batches.size(); ++i )
+   {
+      BOOST_REQUIRE_EQUAL( batches[i].transactions.size(), 1u );
+      BOOST_CHECK( batches[i].transactions[0].id() == transactions[i].id() );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( empty_request_sends_nothing )
+{
+   BOOST_CHECK( trx_batch_message::split( std::vector< message >() ).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
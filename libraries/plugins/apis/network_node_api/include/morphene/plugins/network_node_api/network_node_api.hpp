@@ -0,0 +1,44 @@
+#pragma once
+#include <morphene/plugins/p2p/p2p_plugin.hpp>
+#include <morphene/plugins/json_rpc/utility.hpp>
+
+#include <graphene/net/node.hpp>
+
+#include <fc/optional.hpp>
+
+namespace morphene { namespace plugins { namespace network_node_api {
+
+using morphene::plugins::json_rpc::void_type;
+
+typedef void_type get_network_telemetry_args;
+
+struct get_network_telemetry_return
+{
+   /** not set until the p2p node has taken its first snapshot, about a second after startup */
+   fc::optional< graphene::net::network_telemetry > telemetry;
+};
+
+typedef void_type get_block_cache_stats_args;
+typedef morphene::plugins::p2p::block_message_cache_stats get_block_cache_stats_return;
+
+namespace detail{ class network_node_api_impl; }
+
+class network_node_api
+{
+   public:
+      network_node_api();
+      ~network_node_api();
+
+      DECLARE_API(
+         (get_network_telemetry)
+         (get_block_cache_stats)
+      )
+
+   private:
+      std::unique_ptr< detail::network_node_api_impl > my;
+};
+
+} } } // morphene::plugins::network_node_api
+
+FC_REFLECT( morphene::plugins::network_node_api::get_network_telemetry_return,
+   (telemetry) )
@@ -0,0 +1,34 @@
+#pragma once
+#include <morphene/plugins/json_rpc/json_rpc_plugin.hpp>
+#include <morphene/plugins/p2p/p2p_plugin.hpp>
+
+#include <appbase/application.hpp>
+
+#define MORPHENE_NETWORK_NODE_API_PLUGIN_NAME "network_node_api"
+
+namespace morphene { namespace plugins { namespace network_node_api {
+
+using namespace appbase;
+
+class network_node_api_plugin : public appbase::plugin< network_node_api_plugin >
+{
+public:
+   APPBASE_PLUGIN_REQUIRES(
+      (morphene::plugins::json_rpc::json_rpc_plugin)
+      (morphene::plugins::p2p::p2p_plugin)
+   )
+
+   network_node_api_plugin();
+   virtual ~network_node_api_plugin();
+
+   static const std::string& name() { static std::string name = MORPHENE_NETWORK_NODE_API_PLUGIN_NAME; return name; }
+
+   virtual void set_program_options( options_description& cli, options_description& cfg ) override;
+   virtual void plugin_initialize( const variables_map& options ) override;
+   virtual void plugin_startup() override;
+   virtual void plugin_shutdown() override;
+
+   std::shared_ptr< class network_node_api > api;
+};
+
+} } } // morphene::plugins::network_node_api
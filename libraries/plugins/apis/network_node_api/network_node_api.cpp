@@ -0,0 +1,55 @@
+#include <morphene/plugins/network_node_api/network_node_api.hpp>
+#include <morphene/plugins/network_node_api/network_node_api_plugin.hpp>
+
+#include <appbase/application.hpp>
+
+namespace morphene { namespace plugins { namespace network_node_api {
+
+namespace detail
+{
+   class network_node_api_impl
+   {
+      public:
+         network_node_api_impl() :
+            _p2p( appbase::app().get_plugin< morphene::plugins::p2p::p2p_plugin >() )
+         {}
+
+         DECLARE_API_IMPL(
+            (get_network_telemetry)
+            (get_block_cache_stats)
+         )
+
+         morphene::plugins::p2p::p2p_plugin& _p2p;
+   };
+
+   DEFINE_API_IMPL( network_node_api_impl, get_network_telemetry )
+   {
+      get_network_telemetry_return result;
+      std::shared_ptr< const graphene::net::network_telemetry > telemetry = _p2p.get_network_telemetry();
+      if( telemetry )
+         result.telemetry = *telemetry;
+      return result;
+   }
+
+   DEFINE_API_IMPL( network_node_api_impl, get_block_cache_stats )
+   {
+      return _p2p.get_block_message_cache_stats();
+   }
+
+} // detail
+
+network_node_api::network_node_api() : my( new detail::network_node_api_impl() )
+{
+   JSON_RPC_REGISTER_API( MORPHENE_NETWORK_NODE_API_PLUGIN_NAME );
+}
+
+network_node_api::~network_node_api() {}
+
+// neither call touches chain state or waits on the p2p thread: the telemetry is a published
+// snapshot and the block cache counters are atomics
+DEFINE_LOCKLESS_APIS( network_node_api,
+   (get_network_telemetry)
+   (get_block_cache_stats)
+)
+
+} } } // morphene::plugins::network_node_api
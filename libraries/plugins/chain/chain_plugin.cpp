@@ -43,7 +43,7 @@ struct generate_block_request
 };
 
 typedef fc::static_variant< const signed_block*, const signed_transaction*, generate_block_request* > write_request_ptr;
-typedef fc::static_variant< boost::promise< void >*, fc::future< void >* > promise_ptr;
+typedef fc::static_variant< boost::promise< void >*, fc::future< void >*, fc::promise< bool >* > promise_ptr;
 
 struct write_context
 {
@@ -52,6 +52,8 @@ struct write_context
    bool                          success = true;
    fc::optional< fc::exception > except;
    promise_ptr                   prom_ptr;
+   fc::promise< bool >::ptr      async_prom;
+   std::shared_ptr< const signed_block > async_block;
 };
 
 namespace detail {
@@ -185,6 +187,8 @@ struct request_promise_visitor
 {
    request_promise_visitor(){}
 
+   write_context* cxt = nullptr;
+
    typedef void result_type;
 
    template< typename T >
@@ -192,6 +196,14 @@ struct request_promise_visitor
    {
       t->set_value();
    }
+
+   void operator()( fc::promise< bool >* p )
+   {
+      if( cxt->except )
+         p->set_exception( cxt->except->dynamic_copy_exception() );
+      else
+         p->set_value( cxt->success );
+   }
 };
 
 void chain_plugin_impl::start_write_processing()
@@ -211,7 +223,8 @@ void chain_plugin_impl::start_write_processing()
        * the write and any exceptions that are thrown, a write context is passed in the queue
        * to the processing thread which it will use to store the results of the write. It is the
        * caller's responsibility to ensure the pointer to the write context remains valid until
-       * the contained promise is complete.
+       * the contained promise is complete. The exception is an asynchronous request, whose
+       * context is heap allocated and deleted here once its fc promise has been set.
        *
        * The loop has two modes, sync mode and live mode. In sync mode we want to process writes
        * as quickly as possible with minimal overhead. The outer loop busy waits on the queue
@@ -240,7 +253,15 @@ void chain_plugin_impl::start_write_processing()
                   req_visitor.skip = cxt->skip;
                   req_visitor.except = &(cxt->except);
                   cxt->success = cxt->req_ptr.visit( req_visitor );
+
+                  // A synchronous caller may destroy its context as soon as its promise is set,
+                  // so whether this thread owns the context is read beforehand. An asynchronous
+                  // context holds a reference to its promise and is deleted once it is set.
+                  bool owned = bool( cxt->async_prom );
+                  prom_visitor.cxt = cxt;
                   cxt->prom_ptr.visit( prom_visitor );
+                  if( owned )
+                     delete cxt;
 
                   if( is_syncing && start - db.head_block_time() < fc::minutes(1) )
                   {
@@ -536,7 +557,7 @@ void chain_plugin::plugin_shutdown()
    ilog("database closed successfully");
 }
 
-bool chain_plugin::accept_block( const morphene::chain::signed_block& block, bool currently_syncing, uint32_t skip )
+void log_sync_progress( const morphene::chain::signed_block& block, bool currently_syncing )
 {
    if (currently_syncing && block.block_num() % 10000 == 0) {
       ilog("Syncing Blockchain --- Got block: #${n} time: ${t} producer: ${p}",
@@ -544,6 +565,11 @@ bool chain_plugin::accept_block( const morphene::chain::signed_block& block, boo
            ("n", block.block_num())
            ("p", block.witness) );
    }
+}
+
+bool chain_plugin::accept_block( const morphene::chain::signed_block& block, bool currently_syncing, uint32_t skip )
+{
+   log_sync_progress( block, currently_syncing );
 
    check_time_in_block( block );
 
@@ -562,6 +588,36 @@ bool chain_plugin::accept_block( const morphene::chain::signed_block& block, boo
    return cxt.success;
 }
 
+fc::future< bool > chain_plugin::accept_block_async( const morphene::chain::signed_block& block, bool currently_syncing, uint32_t skip )
+{
+   log_sync_progress( block, currently_syncing );
+
+   fc::promise< bool >::ptr prom( new fc::promise< bool >( "chain_plugin::accept_block_async" ) );
+
+   try
+   {
+      check_time_in_block( block );
+   }
+   catch( const fc::exception& e )
+   {
+      prom->set_exception( e.dynamic_copy_exception() );
+      return fc::future< bool >( prom );
+   }
+
+   // The caller may stop waiting on the future (its task can be canceled) while the block is
+   // still queued, so the context keeps its own copy of the block.
+   std::unique_ptr< write_context > cxt( new write_context() );
+   cxt->async_block = std::make_shared< const signed_block >( block );
+   cxt->req_ptr = cxt->async_block.get();
+   cxt->skip = skip;
+   cxt->async_prom = prom;
+   cxt->prom_ptr = prom.get();
+
+   my->write_queue.push( cxt.release() );
+
+   return fc::future< bool >( prom );
+}
+
 void chain_plugin::accept_transaction( const morphene::chain::signed_transaction& trx )
 {
    boost::promise< void > prom;
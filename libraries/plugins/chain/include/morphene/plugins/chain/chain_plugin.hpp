@@ -2,6 +2,8 @@
 #include <appbase/application.hpp>
 #include <morphene/chain/database.hpp>
 
+#include <fc/thread/future.hpp>
+
 #include <boost/signals2.hpp>
 
 #define MORPHENE_CHAIN_PLUGIN_NAME "chain"
@@ -34,6 +36,15 @@ public:
    virtual void plugin_shutdown() override;
 
    bool accept_block( const morphene::chain::signed_block& block, bool currently_syncing, uint32_t skip );
+
+   /**
+    * Queues a block for the write thread and returns without waiting for it to be applied.
+    * The returned future completes with the result of push_block, or with the exception it
+    * threw. Waiting on the future from an fc::thread yields to the other tasks on that thread
+    * instead of blocking it. The block is copied, so the caller does not have to keep it alive
+    * until the future completes.
+    */
+   fc::future< bool > accept_block_async( const morphene::chain::signed_block& block, bool currently_syncing, uint32_t skip );
    void accept_transaction( const morphene::chain::signed_transaction& trx );
    morphene::chain::signed_block generate_block(
       const fc::time_point_sec when,
@@ -3,7 +3,9 @@
 #include <appbase/application.hpp>
 
 #include <fc/variant.hpp>
+#include <fc/io/datastream.hpp>
 #include <fc/io/json.hpp>
+#include <fc/io/raw_fwd.hpp>
 #include <fc/reflect/variant.hpp>
 #include <fc/exception/exception.hpp>
 
@@ -33,6 +35,20 @@
  *
  * For methods that do not require arguments, use api_void_args
  * as the argument type.
+ *
+ * Every method can also be called without building a variant by
+ * sending a binary websocket frame containing:
+ *
+ *    uint32_t id, uint32_t method_id, fc::raw packed method_args
+ *
+ * The reply is a binary frame containing:
+ *
+ *    uint32_t id, int32_t code, fc::raw packed method_return
+ *
+ * where code is 0 on success. On failure code is one of the JSON_RPC
+ * error codes below and is followed by an fc::raw packed error message
+ * instead of the return value. A method's id is the city_hash32 of its
+ * canonical "api.method" name and is listed by jsonrpc.get_method_ids.
  */
 
 #define MORPHENE_JSON_RPC_PLUGIN_NAME "json_rpc"
@@ -65,6 +81,15 @@ using namespace appbase;
  */
 typedef std::function< fc::variant(const fc::variant&) > api_method;
 
+/**
+ * @brief Internal type used to bind api methods
+ * to ids for the binary transport.
+ *
+ * Arguments: Stream over the fc::raw packed arg type. The
+ * fc::raw packed return value is appended to the string.
+ */
+typedef std::function< void(fc::datastream< const char* >&, std::string&) > api_raw_method;
+
 /**
  * @brief An API, containing APIs and Methods
  *
@@ -100,8 +125,10 @@ class json_rpc_plugin : public appbase::plugin< json_rpc_plugin >
       virtual void plugin_startup() override;
       virtual void plugin_shutdown() override;
 
-      void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig );
+      void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+         const api_raw_method& raw_api = api_raw_method() );
       string call( const string& body );
+      string call_raw( const string& body );
 
    private:
       std::unique_ptr< detail::json_rpc_plugin_impl > my;
@@ -130,7 +157,27 @@ namespace detail {
                {
                   return fc::variant( (plugin.*method)( args.as< Args >(), true ) );
                },
-               api_method_signature{ fc::variant( Args() ), fc::variant( Ret() ) } );
+               api_method_signature{ fc::variant( Args() ), fc::variant( Ret() ) },
+               [&plugin,method]( fc::datastream< const char* >& ds, std::string& out )
+               {
+                  Args args;
+                  try
+                  {
+                     fc::raw::unpack( ds, args );
+                  }
+                  catch( fc::exception& e )
+                  {
+                     FC_THROW_EXCEPTION( fc::parse_error_exception, "Could not unpack arguments: ${e}", ("e", e.to_string()) );
+                  }
+                  if( ds.remaining() != 0 )
+                     FC_THROW_EXCEPTION( fc::parse_error_exception, "${n} unexpected bytes after arguments", ("n", ds.remaining()) );
+
+                  Ret ret = (plugin.*method)( args, true );
+                  size_t offset = out.size();
+                  out.resize( offset + fc::raw::pack_size( ret ) );
+                  fc::datastream< char* > rs( &out[ offset ], out.size() - offset );
+                  fc::raw::pack( rs, ret );
+               } );
          }
 
       private:
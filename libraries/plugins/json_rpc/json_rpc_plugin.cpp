@@ -9,6 +9,8 @@
 #include <fc/exception/exception.hpp>
 #include <fc/macros.hpp>
 #include <fc/io/fstream.hpp>
+#include <fc/crypto/city.hpp>
+#include <fc/io/raw.hpp>
 
 #include <chainbase/chainbase.hpp>
 
@@ -49,6 +51,15 @@ namespace detail
 
    typedef api_method_signature  get_signature_return;
 
+   typedef void_type                   get_method_ids_args;
+   typedef map< string, uint32_t >     get_method_ids_return;
+
+   struct raw_api_method
+   {
+      string            name;
+      api_raw_method    call;
+   };
+
    class json_rpc_logger
    {
    public:
@@ -133,13 +144,15 @@ namespace detail
          json_rpc_plugin_impl();
          ~json_rpc_plugin_impl();
 
-         void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig );
+         void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+            const api_raw_method& raw_api );
 
          api_method* find_api_method( std::string api, std::string method );
          api_method* process_params( string method, const fc::variant_object& request, fc::variant& func_args, string* method_name );
          void rpc_id( const fc::variant_object& request, json_rpc_response& response );
          void rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response );
          json_rpc_response rpc( const fc::variant& message );
+         string rpc_raw( const string& message );
 
          void initialize();
 
@@ -151,18 +164,21 @@ namespace detail
 
          DECLARE_API(
             (get_methods)
-            (get_signature) )
+            (get_signature)
+            (get_method_ids) )
 
          map< string, api_description >                     _registered_apis;
          vector< string >                                   _methods;
          map< string, map< string, api_method_signature > > _method_sigs;
+         map< uint32_t, raw_api_method >                    _raw_apis;
          std::unique_ptr< json_rpc_logger >                 _logger;
    };
 
    json_rpc_plugin_impl::json_rpc_plugin_impl() {}
    json_rpc_plugin_impl::~json_rpc_plugin_impl() {}
 
-   void json_rpc_plugin_impl::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig )
+   void json_rpc_plugin_impl::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+      const api_raw_method& raw_api )
    {
       _registered_apis[ api_name ][ method_name ] = api;
       _method_sigs[ api_name ][ method_name ] = sig;
@@ -170,6 +186,15 @@ namespace detail
       std::stringstream canonical_name;
       canonical_name << api_name << '.' << method_name;
       _methods.push_back( canonical_name.str() );
+
+      if( raw_api )
+      {
+         uint32_t method_id = fc::city_hash32( _methods.back().c_str(), _methods.back().size() );
+         auto itr = _raw_apis.find( method_id );
+         FC_ASSERT( itr == _raw_apis.end() || itr->second.name == _methods.back(),
+            "Method ${a} has the same id as ${b}", ("a", _methods.back())("b", itr->second.name) );
+         _raw_apis[ method_id ] = raw_api_method{ _methods.back(), raw_api };
+      }
    }
 
    void json_rpc_plugin_impl::initialize()
@@ -199,6 +224,17 @@ namespace detail
       return method_itr->second;
    }
 
+   get_method_ids_return json_rpc_plugin_impl::get_method_ids( const get_method_ids_args& args, bool lock )
+   {
+      FC_UNUSED( lock )
+      get_method_ids_return result;
+
+      for( const auto& m : _raw_apis )
+         result[ m.second.name ] = m.first;
+
+      return result;
+   }
+
    api_method* json_rpc_plugin_impl::find_api_method( std::string api, std::string method )
    {
       STATSD_START_TIMER( "jsonrpc", "overhead", "find_api_method", 1.0f );
@@ -397,6 +433,89 @@ namespace detail
 
       return response;
    }
+
+   string json_rpc_plugin_impl::rpc_raw( const string& message )
+   {
+      STATSD_START_TIMER( "jsonrpc", "overhead", "total_raw", 1.0f );
+
+      uint32_t id = 0;
+      uint32_t method_id = 0;
+      int32_t code = 0;
+      string error;
+
+      // The reply header is filled in last, the result is appended after it
+      string response( sizeof( id ) + sizeof( code ), '\0' );
+
+      try
+      {
+         if( message.size() < sizeof( id ) + sizeof( method_id ) )
+         {
+            code = JSON_RPC_PARSE_ERROR;
+            error = "Binary request is too short";
+         }
+         else
+         {
+            fc::datastream< const char* > ds( message.data(), message.size() );
+            fc::raw::unpack( ds, id );
+            fc::raw::unpack( ds, method_id );
+
+            auto itr = _raw_apis.find( method_id );
+            if( itr == _raw_apis.end() )
+            {
+               code = JSON_RPC_METHOD_NOT_FOUND;
+               error = "Could not find method with id " + std::to_string( method_id );
+            }
+            else
+            {
+               STATSD_START_TIMER( "jsonrpc", "api", itr->second.name, 1.0f );
+               itr->second.call( ds, response );
+            }
+         }
+      }
+      catch( fc::parse_error_exception& e )
+      {
+         code = JSON_RPC_PARSE_PARAMS_ERROR;
+         error = e.to_string();
+      }
+      catch( chainbase::lock_exception& e )
+      {
+         code = JSON_RPC_ERROR_DURING_CALL;
+         error = e.what();
+      }
+      catch( fc::assert_exception& e )
+      {
+         code = JSON_RPC_ERROR_DURING_CALL;
+         error = e.to_string();
+      }
+      catch( fc::exception& e )
+      {
+         code = JSON_RPC_SERVER_ERROR;
+         error = e.to_string();
+      }
+      catch( std::exception& e )
+      {
+         code = JSON_RPC_SERVER_ERROR;
+         error = e.what();
+      }
+      catch( ... )
+      {
+         code = JSON_RPC_SERVER_ERROR;
+         error = "Unknown error - binary rpc call failed";
+      }
+
+      if( code != 0 )
+      {
+         auto packed_error = fc::raw::pack_to_vector( error );
+         response.resize( sizeof( id ) + sizeof( code ) );
+         response.append( packed_error.data(), packed_error.size() );
+      }
+
+      fc::datastream< char* > header( &response[0], sizeof( id ) + sizeof( code ) );
+      fc::raw::pack( header, id );
+      fc::raw::pack( header, code );
+
+      return response;
+   }
 }
 
 using detail::json_rpc_error;
@@ -437,9 +556,10 @@ void json_rpc_plugin::plugin_startup()
 
 void json_rpc_plugin::plugin_shutdown() {}
 
-void json_rpc_plugin::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig )
+void json_rpc_plugin::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+   const api_raw_method& raw_api )
 {
-   my->add_api_method( api_name, method_name, api, sig );
+   my->add_api_method( api_name, method_name, api, sig, raw_api );
 }
 
 string json_rpc_plugin::call( const string& message )
@@ -492,6 +612,12 @@ string json_rpc_plugin::call( const string& message )
 
 }
 
+string json_rpc_plugin::call_raw( const string& message )
+{
+   STATSD_START_TIMER( "jsonrpc", "overhead", "call_raw", 1.0f );
+   return my->rpc_raw( message );
+}
+
 } } } // morphene::plugins::json_rpc
 
 FC_REFLECT( morphene::plugins::json_rpc::detail::json_rpc_error, (code)(message)(data) )
@@ -0,0 +1,93 @@
+// json_rpc_plugin.hpp is included before the protocol headers, as it is by the API plugins.
+// The fc::raw overloads those headers declare, such as the ones for fixed_string, must still be
+// used when packing and unpacking calls.
+#include <morphene/plugins/json_rpc/json_rpc_plugin.hpp>
+#include <morphene/plugins/json_rpc/utility.hpp>
+
+#include <morphene/protocol/transaction.hpp>
+#include <morphene/protocol/morphene_operations.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/city.hpp>
+
+using namespace morphene::plugins::json_rpc;
+using namespace morphene::protocol;
+
+struct make_transfer_args
+{
+   account_name_type from;
+   account_name_type to;
+   legacy_asset      amount;
+   uint16_t          ref_block_num = 0;
+};
+
+typedef signed_transaction make_transfer_return;
+
+class protocol_api
+{
+   public:
+      DECLARE_API( (make_transfer) )
+};
+
+make_transfer_return protocol_api::make_transfer( const make_transfer_args& args, bool lock )
+{
+   transfer_operation op;
+   op.from = args.from;
+   op.to = args.to;
+   op.amount = args.amount;
+
+   signed_transaction trx;
+   trx.ref_block_num = args.ref_block_num;
+   trx.operations.push_back( op );
+   return trx;
+}
+
+FC_REFLECT( make_transfer_args, (from)(to)(amount)(ref_block_num) )
+
+BOOST_AUTO_TEST_SUITE( protocol_api_tests )
+
+BOOST_AUTO_TEST_CASE( declared_api_round_trips_protocol_types )
+{
+   auto& plugin = appbase::app().register_plugin< json_rpc_plugin >();
+   plugin.initialize( boost::program_options::variables_map() );
+
+   protocol_api api;
+   detail::register_api_method_visitor visitor( "protocol_api" );
+   api.for_each_api( visitor );
+
+   make_transfer_args args;
+   args.from = "alice";
+   args.to = "bob";
+   args.amount = legacy_asset( 1234, MORPH_SYMBOL );
+   args.ref_block_num = 42;
+
+   std::string method = "protocol_api.make_transfer";
+   std::vector< char > frame = fc::raw::pack_to_vector( uint32_t( 3 ) );
+   std::vector< char > rest = fc::raw::pack_to_vector( fc::city_hash32( method.c_str(), method.size() ) );
+   frame.insert( frame.end(), rest.begin(), rest.end() );
+   rest = fc::raw::pack_to_vector( args );
+   frame.insert( frame.end(), rest.begin(), rest.end() );
+
+   std::string response = plugin.call_raw( std::string( frame.begin(), frame.end() ) );
+   fc::datastream< const char* > ds( response.data(), response.size() );
+   uint32_t id = 0;
+   int32_t code = -1;
+   signed_transaction trx;
+   fc::raw::unpack( ds, id );
+   fc::raw::unpack( ds, code );
+   BOOST_REQUIRE_EQUAL( code, 0 );
+   fc::raw::unpack( ds, trx );
+   BOOST_CHECK_EQUAL( ds.remaining(), 0u );
+
+   BOOST_CHECK_EQUAL( id, 3u );
+   BOOST_CHECK_EQUAL( trx.ref_block_num, 42u );
+   BOOST_REQUIRE_EQUAL( trx.operations.size(), 1u );
+   const auto& op = trx.operations[0].get< transfer_operation >();
+   BOOST_CHECK_EQUAL( std::string( op.from ), "alice" );
+   BOOST_CHECK_EQUAL( std::string( op.to ), "bob" );
+   BOOST_CHECK_EQUAL( op.amount.amount.value, 1234 );
+   BOOST_CHECK( fc::raw::pack_to_vector( trx ) == fc::raw::pack_to_vector( make_transfer_return( api.make_transfer( args ) ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
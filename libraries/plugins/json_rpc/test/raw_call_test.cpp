@@ -0,0 +1,188 @@
+#define BOOST_TEST_MODULE json_rpc test
+
+#include <boost/test/unit_test.hpp>
+
+#include <morphene/plugins/json_rpc/json_rpc_plugin.hpp>
+
+#include <fc/crypto/city.hpp>
+#include <fc/io/raw.hpp>
+
+#include <unordered_map>
+
+using namespace morphene::plugins::json_rpc;
+
+struct echo_args
+{
+   std::string                text;
+   uint32_t                   count = 0;
+};
+
+struct echo_return
+{
+   std::vector< std::string > texts;
+};
+
+FC_REFLECT( echo_args, (text)(count) )
+FC_REFLECT( echo_return, (texts) )
+
+struct test_api
+{
+   echo_return echo( const echo_args& args, bool lock )
+   {
+      FC_ASSERT( args.count <= 100, "count is too large" );
+      return echo_return{ std::vector< std::string >( args.count, args.text ) };
+   }
+};
+
+struct raw_reply
+{
+   uint32_t          id = 0;
+   int32_t           code = 0;
+   std::vector<char> payload;
+
+   template< typename T >
+   T as()const
+   {
+      fc::datastream< const char* > ds( payload.data(), payload.size() );
+      T result;
+      fc::raw::unpack( ds, result );
+      BOOST_REQUIRE_EQUAL( ds.remaining(), 0u );
+      return result;
+   }
+};
+
+struct raw_call_fixture
+{
+   raw_call_fixture()
+      : plugin( appbase::app().register_plugin< json_rpc_plugin >() )
+   {
+      // APIs can only be registered with an initialized plugin
+      plugin.initialize( boost::program_options::variables_map() );
+      detail::register_api_method_visitor visitor( "test_api" );
+      visitor( api, "echo", &test_api::echo, (echo_args*)nullptr, (echo_return*)nullptr );
+   }
+
+   static uint32_t method_id( const std::string& name )
+   {
+      return fc::city_hash32( name.c_str(), name.size() );
+   }
+
+   template< typename Args >
+   static std::string frame( uint32_t id, uint32_t method, const Args& args )
+   {
+      std::vector<char> data = fc::raw::pack_to_vector( id );
+      std::vector<char> m = fc::raw::pack_to_vector( method );
+      std::vector<char> a = fc::raw::pack_to_vector( args );
+      data.insert( data.end(), m.begin(), m.end() );
+      data.insert( data.end(), a.begin(), a.end() );
+      return std::string( data.begin(), data.end() );
+   }
+
+   raw_reply call( const std::string& message )
+   {
+      std::string response = plugin.call_raw( message );
+      BOOST_REQUIRE( response.size() >= sizeof( uint32_t ) + sizeof( int32_t ) );
+
+      raw_reply reply;
+      fc::datastream< const char* > ds( response.data(), response.size() );
+      fc::raw::unpack( ds, reply.id );
+      fc::raw::unpack( ds, reply.code );
+      reply.payload.assign( response.begin() + ds.tellp(), response.end() );
+      return reply;
+   }
+
+   json_rpc_plugin& plugin;
+   test_api         api;
+};
+
+BOOST_FIXTURE_TEST_SUITE( raw_call_tests, raw_call_fixture )
+
+BOOST_AUTO_TEST_CASE( typed_call_round_trips )
+{
+   auto reply = call( frame( 7, method_id( "test_api.echo" ), echo_args{ "abc", 3 } ) );
+   BOOST_REQUIRE_EQUAL( reply.code, 0 );
+   BOOST_CHECK_EQUAL( reply.id, 7u );
+
+   auto result = reply.as< echo_return >();
+   BOOST_REQUIRE_EQUAL( result.texts.size(), 3u );
+   for( const auto& text : result.texts )
+      BOOST_CHECK_EQUAL( text, "abc" );
+
+   // an exception thrown by the method is returned as an error
+   reply = call( frame( 8, method_id( "test_api.echo" ), echo_args{ "abc", 101 } ) );
+   BOOST_CHECK_EQUAL( reply.id, 8u );
+   BOOST_CHECK_EQUAL( reply.code, JSON_RPC_ERROR_DURING_CALL );
+   BOOST_CHECK( reply.as< std::string >().find( "count is too large" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( unknown_method_id )
+{
+   uint32_t unknown = method_id( "test_api.echo" ) + 1;
+   auto reply = call( frame( 9, unknown, echo_args{ "abc", 1 } ) );
+   BOOST_CHECK_EQUAL( reply.id, 9u );
+   BOOST_CHECK_EQUAL( reply.code, JSON_RPC_METHOD_NOT_FOUND );
+   BOOST_CHECK( reply.as< std::string >().find( std::to_string( unknown ) ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( trailing_bytes_are_rejected )
+{
+   std::string message = frame( 10, method_id( "test_api.echo" ), echo_args{ "abc", 1 } ) + "x";
+   auto reply = call( message );
+   BOOST_CHECK_EQUAL( reply.id, 10u );
+   BOOST_CHECK_EQUAL( reply.code, JSON_RPC_PARSE_PARAMS_ERROR );
+}
+
+BOOST_AUTO_TEST_CASE( short_frame_is_rejected )
+{
+   for( size_t size = 0; size < sizeof( uint32_t ) * 2; ++size )
+   {
+      auto reply = call( std::string( size, '\x01' ) );
+      BOOST_CHECK_EQUAL( reply.id, 0u );
+      BOOST_CHECK_EQUAL( reply.code, JSON_RPC_PARSE_ERROR );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( truncated_args_are_rejected )
+{
+   std::string message = frame( 11, method_id( "test_api.echo" ), echo_args{ "a longer text", 2 } );
+   for( size_t size = sizeof( uint32_t ) * 2; size < message.size(); ++size )
+   {
+      auto reply = call( message.substr( 0, size ) );
+      BOOST_CHECK_EQUAL( reply.id, 11u );
+      BOOST_CHECK_EQUAL( reply.code, JSON_RPC_PARSE_PARAMS_ERROR );
+   }
+
+   // a string length far past the end of the frame
+   std::string oversized = frame( 12, method_id( "test_api.echo" ), fc::unsigned_int( 0x7fffffff ) );
+   auto reply = call( oversized );
+   BOOST_CHECK_EQUAL( reply.id, 12u );
+   BOOST_CHECK_EQUAL( reply.code, JSON_RPC_PARSE_PARAMS_ERROR );
+}
+
+BOOST_AUTO_TEST_CASE( registration_rejects_id_collisions )
+{
+   // find two method names with the same id
+   std::unordered_map< uint32_t, std::string > names;
+   std::string first, second;
+   for( uint32_t i = 0; second.empty(); ++i )
+   {
+      std::string name = "m" + std::to_string( i );
+      auto result = names.emplace( method_id( "collide_api." + name ), name );
+      if( !result.second )
+      {
+         first = result.first->second;
+         second = name;
+      }
+   }
+
+   api_raw_method raw = []( fc::datastream< const char* >&, std::string& ) {};
+   api_method method = []( const fc::variant& ) { return fc::variant(); };
+   api_method_signature sig{ fc::variant(), fc::variant() };
+
+   plugin.add_api_method( "collide_api", first, method, sig, raw );
+   // registering the same method again is allowed
+   plugin.add_api_method( "collide_api", first, method, sig, raw );
+   BOOST_CHECK_THROW( plugin.add_api_method( "collide_api", second, method, sig, raw ), fc::assert_exception );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,11 +6,24 @@
 
 #define MORPHENE_P2P_PLUGIN_NAME "p2p"
 
+namespace graphene { namespace net { struct network_telemetry; } }
+
 namespace morphene { namespace plugins { namespace p2p {
 namespace bpo = boost::program_options;
 
 namespace detail { class p2p_plugin_impl; }
 
+/** counters for the cache of packed blocks served to peers */
+struct block_message_cache_stats
+{
+   uint64_t hits = 0;
+   uint64_t misses = 0;
+   uint64_t evictions = 0;
+   uint64_t entries = 0;
+   uint64_t size_in_bytes = 0;
+   uint64_t capacity_in_bytes = 0;
+};
+
 class p2p_plugin : public appbase::plugin<p2p_plugin> {
 public:
    APPBASE_PLUGIN_REQUIRES((plugins::chain::chain_plugin))
@@ -30,9 +43,14 @@ public:
    void broadcast_block( const morphene::protocol::signed_block& block );
    void broadcast_transaction( const morphene::protocol::signed_transaction& tx );
    void set_block_production( bool producing_blocks );
+   block_message_cache_stats get_block_message_cache_stats() const;
+   std::shared_ptr< const graphene::net::network_telemetry > get_network_telemetry() const;
 
 private:
    std::unique_ptr< detail::p2p_plugin_impl > my;
 };
 
 } } } // morphene::plugins::p2p
+
+FC_REFLECT( morphene::plugins::p2p::block_message_cache_stats,
+            (hits)(misses)(evictions)(entries)(size_in_bytes)(capacity_in_bytes) )
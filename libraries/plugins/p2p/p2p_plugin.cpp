@@ -18,9 +18,15 @@
 
 #include <boost/any.hpp>
 
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <mutex>
 
 using std::string;
 using std::vector;
@@ -73,16 +79,108 @@ std::vector<fc::ip::endpoint> resolve_string_to_ip_endpoints( const std::string&
    FC_CAPTURE_AND_RETHROW( (endpoint_string) )
 }
 
+/**
+ * Blocks we have packed to serve to peers, most recently used first.  During sync many peers ask
+ * for the same ranges, and a hit costs a copy of the packed message instead of a block_log read
+ * and a repack.  A block id includes the block's hash, so entries never go stale across forks.
+ *
+ * Only modified from the p2p thread.  The counters are atomics so that get_stats() can be called
+ * from API threads without waiting on the p2p thread.
+ */
+class block_message_cache
+{
+   public:
+      void set_capacity( uint64_t capacity_in_bytes )
+      {
+         _capacity_in_bytes = capacity_in_bytes;
+         evict();
+      }
+
+      fc::optional< message > get( const block_id_type& block_id )
+      {
+         auto& by_id = _entries.get< by_block_id >();
+         auto itr = by_id.find( block_id );
+         if( itr == by_id.end() )
+         {
+            ++_misses;
+            STATSD_INCREMENT( "p2p", "block_message_cache", "miss", 1.0f );
+            return fc::optional< message >();
+         }
+
+         ++_hits;
+         STATSD_INCREMENT( "p2p", "block_message_cache", "hit", 1.0f );
+         _entries.relocate( _entries.begin(), _entries.project< 0 >( itr ) );
+         return itr->packed_block;
+      }
+
+      void put( const block_id_type& block_id, const message& packed_block )
+      {
+         if( packed_block.data.size() > _capacity_in_bytes )
+            return;
+
+         auto result = _entries.push_front( entry{ block_id, packed_block } );
+         if( !result.second )
+            return;
+
+         _size_in_bytes += packed_block.data.size();
+         _entry_count = _entries.size();
+         evict();
+      }
+
+      block_message_cache_stats get_stats() const
+      {
+         block_message_cache_stats stats;
+         stats.hits = _hits.load( std::memory_order_relaxed );
+         stats.misses = _misses.load( std::memory_order_relaxed );
+         stats.evictions = _evictions.load( std::memory_order_relaxed );
+         stats.entries = _entry_count.load( std::memory_order_relaxed );
+         stats.size_in_bytes = _size_in_bytes.load( std::memory_order_relaxed );
+         stats.capacity_in_bytes = _capacity_in_bytes.load( std::memory_order_relaxed );
+         return stats;
+      }
+
+   private:
+      void evict()
+      {
+         while( _size_in_bytes > _capacity_in_bytes && !_entries.empty() )
+         {
+            _size_in_bytes -= _entries.back().packed_block.data.size();
+            _entries.pop_back();
+            ++_evictions;
+         }
+         _entry_count = _entries.size();
+      }
+
+      struct entry
+      {
+         block_id_type block_id;
+         message       packed_block;
+      };
+
+      struct by_block_id;
+      typedef boost::multi_index_container< entry,
+         boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique< boost::multi_index::tag< by_block_id >,
+               boost::multi_index::member< entry, block_id_type, &entry::block_id >, std::hash< block_id_type > >
+         >
+      > entry_index_type;
+
+      entry_index_type          _entries;
+      std::atomic< uint64_t >   _hits{ 0 };
+      std::atomic< uint64_t >   _misses{ 0 };
+      std::atomic< uint64_t >   _evictions{ 0 };
+      std::atomic< uint64_t >   _entry_count{ 0 };
+      std::atomic< uint64_t >   _size_in_bytes{ 0 };
+      std::atomic< uint64_t >   _capacity_in_bytes{ 0 };
+};
+
 class p2p_plugin_impl : public graphene::net::node_delegate
 {
 public:
 
    p2p_plugin_impl( plugins::chain::chain_plugin& c )
-      : running(true), activeHandleBlock(false), activeHandleTx(false), chain( c )
-   {
-      handleBlockFinished.second = std::shared_future<void>(handleBlockFinished.first.get_future());
-      handleTxFinished.second = std::shared_future<void>(handleTxFinished.first.get_future());
-   }
+      : running(true), chain( c ) {}
    virtual ~p2p_plugin_impl() {}
 
    bool is_included_block(const block_id_type& block_id);
@@ -113,14 +211,32 @@ public:
    bool force_validate = false;
    bool block_producer = false;
    std::atomic_bool   running;
-   std::atomic_bool   activeHandleBlock;
-   std::atomic_bool   activeHandleTx;
-   typedef std::pair<std::promise<void>, std::shared_future<void>> handler_state;
+
+   /**
+    * Tracks the calls of one handler that are in flight. Several handle_block calls can wait on
+    * the write thread at once, so the barrier is signaled once, when the last of them finishes
+    * after shutdown started.
+    */
+   struct handler_state
+   {
+      handler_state() : finished( done.get_future() ) {}
+
+      void signal()
+      {
+         std::call_once( signaled, [this]() { done.set_value(); } );
+      }
+
+      std::atomic< uint32_t >    active{ 0 };
+      std::promise< void >       done;
+      std::shared_future< void > finished;
+      std::once_flag             signaled;
+   };
 
    handler_state handleBlockFinished;
    handler_state handleTxFinished;
 
    std::unique_ptr<graphene::net::node> node;
+   block_message_cache packed_blocks;
 
    plugins::chain::chain_plugin& chain;
 
@@ -130,26 +246,25 @@ private:
    class shutdown_helper final
    {
    public:
-      shutdown_helper(p2p_plugin_impl& impl, std::atomic_bool& activityFlag,
-         handler_state& barrier) :
-         _impl(impl), _barrier(barrier), _activityFlag(activityFlag)
+      // The call is counted before running is checked, so plugin_shutdown either sees it in
+      // flight or the call sees that shutdown started.
+      shutdown_helper(p2p_plugin_impl& impl, handler_state& barrier) :
+         _impl(impl), _barrier(barrier)
       {
-         _activityFlag.store(true);
+         ++_barrier.active;
       }
       ~shutdown_helper()
       {
-         _activityFlag.store(false);
-         if(_impl.running.load() == false && _barrier.second.valid() == false)
+         if(--_barrier.active == 0 && _impl.running.load() == false)
          {
             ilog("Sending notification to shutdown barrier.");
-            _barrier.first.set_value();
+            _barrier.signal();
          }
       }
 
    private:
       p2p_plugin_impl&    _impl;
       handler_state&      _barrier;
-      std::atomic_bool&   _activityFlag;
    };
 
 };
@@ -172,34 +287,33 @@ bool p2p_plugin_impl::has_item( const graphene::net::item_id& id )
 
 bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg, bool sync_mode, std::vector<fc::uint160_t>& )
 { try {
+   shutdown_helper helper(*this, handleBlockFinished);
+
    if( running.load() )
    {
-      shutdown_helper helper(*this, activeHandleBlock, handleBlockFinished);
-
-      uint32_t head_block_num;
-      chain.db().with_read_lock( [&]()
-      {
-         head_block_num = chain.db().head_block_num();
-      });
+      // The head block is not read here. Taking the read lock would stall the whole p2p thread
+      // while the write thread holds the write lock applying earlier blocks.
       if (sync_mode)
          fc_ilog(fc::logger::get("sync"),
-               "chain pushing sync block #${block_num} ${block_hash}, head is ${head}",
+               "chain pushing sync block #${block_num} ${block_hash}",
                ("block_num", blk_msg.block.block_num())
-               ("block_hash", blk_msg.block_id)
-               ("head", head_block_num));
+               ("block_hash", blk_msg.block_id));
       else
          fc_ilog(fc::logger::get("sync"),
-               "chain pushing block #${block_num} ${block_hash}, head is ${head}",
+               "chain pushing block #${block_num} ${block_hash}",
                ("block_num", blk_msg.block.block_num())
-               ("block_hash", blk_msg.block_id)
-               ("head", head_block_num));
+               ("block_hash", blk_msg.block_id));
 
       try {
          // TODO: in the case where this block is valid but on a fork that's too old for us to switch to,
          // you can help the network code out by throwing a block_older_than_undo_history exception.
          // when the net code sees that, it will stop trying to push blocks from that chain, but
          // leave that peer connected so that they can get sync blocks from us
-         bool result = chain.accept_block( blk_msg.block, sync_mode, ( block_producer | force_validate ) ? chain::database::skip_nothing : chain::database::skip_transaction_signatures );
+         // The block is queued to the chain's write thread and this task yields until it has been
+         // applied, so the p2p thread keeps fetching and serving peers in the meantime. The node
+         // bounds the number of blocks in flight and hands them over in order, so several sync
+         // blocks can be queued while earlier ones are still being applied.
+         bool result = chain.accept_block_async( blk_msg.block, sync_mode, ( block_producer | force_validate ) ? chain::database::skip_nothing : chain::database::skip_transaction_signatures ).wait();
 
          if( !sync_mode )
          {
@@ -216,16 +330,20 @@ bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg,
       } catch ( const chain::unlinkable_block_exception& e ) {
          // translate to a graphene::net exception
          fc_elog(fc::logger::get("sync"),
-               "Error when pushing block, current head block is ${head}:\n${e}",
+               "Error when pushing block #${block_num}:\n${e}",
                ("e", e.to_detail_string())
-               ("head", head_block_num));
+               ("block_num", blk_msg.block.block_num()));
          elog("Error when pushing block:\n${e}", ("e", e.to_detail_string()));
          FC_THROW_EXCEPTION(graphene::net::unlinkable_block_exception, "Error when pushing block:\n${e}", ("e", e.to_detail_string()));
+      } catch( const fc::canceled_exception& ) {
+         // The node is closing. The write context owns a copy of the block, so the push can
+         // still finish on the write thread after this task is gone.
+         throw;
       } catch( const fc::exception& e ) {
          fc_elog(fc::logger::get("sync"),
-               "Error when pushing block, current head block is ${head}:\n${e}",
+               "Error when pushing block #${block_num}:\n${e}",
                ("e", e.to_detail_string())
-               ("head", head_block_num));
+               ("block_num", blk_msg.block.block_num()));
          elog("Error when pushing block:\n${e}", ("e", e.to_detail_string()));
          throw;
       }
@@ -233,8 +351,6 @@ bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg,
    else
    {
       ilog("Block ignored due to started p2p_plugin shutdown");
-      if(handleBlockFinished.second.valid() == false)
-         handleBlockFinished.first.set_value();
       FC_THROW("Preventing further processing of ignored block...");
    }
    return false;
@@ -242,12 +358,12 @@ bool p2p_plugin_impl::handle_block( const graphene::net::block_message& blk_msg,
 
 void p2p_plugin_impl::handle_transaction( const graphene::net::trx_message& trx_msg )
 {
+   shutdown_helper helper(*this, handleTxFinished);
+
    if(running.load())
    {
       try
       {
-         shutdown_helper helper(*this, activeHandleTx, handleTxFinished);
-
          chain.accept_transaction( trx_msg.trx );
 
       } FC_CAPTURE_AND_RETHROW( (trx_msg) )
@@ -255,8 +371,6 @@ void p2p_plugin_impl::handle_transaction( const graphene::net::trx_message& trx_
    else
    {
       ilog("Transaction ignored due to started p2p_plugin shutdown");
-      if(handleTxFinished.second.valid() == false)
-         handleTxFinished.first.set_value();
 
       FC_THROW("Preventing further processing of ignored transaction...");
    }
@@ -326,7 +440,11 @@ graphene::net::message p2p_plugin_impl::get_item( const graphene::net::item_id&
 { try {
    if( id.item_type == graphene::net::block_message_type )
    {
-      return chain.db().with_read_lock( [&]()
+      fc::optional< message > cached_block = packed_blocks.get( id.item_hash );
+      if( cached_block )
+         return std::move( *cached_block );
+
+      message packed_block = chain.db().with_read_lock( [&]()
       {
          auto opt_block = chain.db().fetch_block_by_id(id.item_hash);
          if( !opt_block )
@@ -334,8 +452,10 @@ graphene::net::message p2p_plugin_impl::get_item( const graphene::net::item_id&
                ("id", id.item_hash)("id2", chain.db().get_block_id_for_num(block_header::num_from_id(id.item_hash))));
          FC_ASSERT( opt_block.valid() );
          // ilog("Serving up block #${num}", ("num", opt_block->block_num()));
-         return block_message(std::move(*opt_block));
+         return message( block_message(std::move(*opt_block)) );
       });
+      packed_blocks.put( id.item_hash, packed_block );
+      return packed_block;
    }
    return chain.db().with_read_lock( [&]()
    {
@@ -558,6 +678,7 @@ void p2p_plugin::set_program_options( bpo::options_description& cli, bpo::option
       ("seed-node", bpo::value<vector<string>>()->composing(), "The IP address and port of a remote peer to sync with. Deprecated in favor of p2p-seed-node.")
       ("p2p-seed-node", bpo::value<vector<string>>()->composing()->default_value( default_seeds, seed_ss.str() ), "The IP address and port of a remote peer to sync with.")
       ("p2p-parameters", bpo::value<string>(), ("P2P network parameters. (Default: " + fc::json::to_string(graphene::net::node_configuration()) + " )").c_str() )
+      ("p2p-block-cache-size-mb", bpo::value<uint64_t>()->default_value(64), "Size in MiB of the cache of packed blocks served to peers.")
       ;
    cli.add_options()
       ("force-validate", bpo::bool_switch()->default_value(false), "Force validation of all transactions. Deprecated in favor of p2p-force-validate" )
@@ -631,6 +752,8 @@ void p2p_plugin::plugin_initialize(const boost::program_options::variables_map&
       fc::variant var = fc::json::from_string( options.at("p2p-parameters").as<string>(), fc::json::strict_parser );
       my->config = var.get_object();
    }
+
+   my->packed_blocks.set_capacity( options.at( "p2p-block-cache-size-mb" ).as< uint64_t >() * 1024 * 1024 );
 }
 
 void p2p_plugin::plugin_startup()
@@ -706,14 +829,14 @@ void p2p_plugin::plugin_shutdown() {
    std::future_status bfState, tfState;
    do
    {
-      if(my->activeHandleBlock.load())
+      if(my->handleBlockFinished.active.load() > 0)
       {
-         bfState = my->handleBlockFinished.second.wait_for(std::chrono::milliseconds(100));
+         bfState = my->handleBlockFinished.finished.wait_for(std::chrono::milliseconds(100));
          if(bfState != std::future_status::ready)
          {
-            ilog("waiting for handle_block finish: ${s}, future status: ${fs}",
+            ilog("waiting for ${n} handle_block calls to finish: ${s}",
+             ("n", my->handleBlockFinished.active.load())
              ("s", fStatus(bfState))
-             ("fs", std::to_string(my->handleBlockFinished.second.valid()))
             );
          }
       }
@@ -722,14 +845,14 @@ void p2p_plugin::plugin_shutdown() {
          bfState = std::future_status::ready;
       }
 
-      if(my->activeHandleTx.load())
+      if(my->handleTxFinished.active.load() > 0)
       {
-         tfState = my->handleTxFinished.second.wait_for(std::chrono::milliseconds(100));
+         tfState = my->handleTxFinished.finished.wait_for(std::chrono::milliseconds(100));
          if(tfState != std::future_status::ready)
          {
-            ilog("waiting for handle_transaction finish: ${s}, future status: ${fs}",
+            ilog("waiting for ${n} handle_transaction calls to finish: ${s}",
+             ("n", my->handleTxFinished.active.load())
              ("s", fStatus(tfState))
-             ("fs", std::to_string(my->handleTxFinished.second.valid()))
             );
          }
       }
@@ -738,10 +861,13 @@ void p2p_plugin::plugin_shutdown() {
          tfState = std::future_status::ready;
       }
    }
-   while(bfState != std::future_status::ready && tfState != std::future_status::ready);
+   while(bfState != std::future_status::ready || tfState != std::future_status::ready);
 
    ilog("P2P Plugin: checking handle_block and handle_transaction activity");
    my->node->close();
+   block_message_cache_stats cache_stats = my->packed_blocks.get_stats();
+   ilog( "P2P block cache served ${h} of ${n} block requests",
+      ("h", cache_stats.hits)("n", cache_stats.hits + cache_stats.misses) );
    fc::promise<void>::ptr quitDone(new fc::promise<void>("P2P thread quit"));
    my->p2p_thread.quit(quitDone.get());
    ilog("Waiting for p2p_thread quit");
@@ -767,4 +893,16 @@ void p2p_plugin::set_block_production( bool producing_blocks )
    my->block_producer = producing_blocks;
 }
 
+std::shared_ptr< const graphene::net::network_telemetry > p2p_plugin::get_network_telemetry() const
+{
+   if( !my->node )
+      return std::shared_ptr< const graphene::net::network_telemetry >();
+   return my->node->get_network_telemetry();
+}
+
+block_message_cache_stats p2p_plugin::get_block_message_cache_stats() const
+{
+   return my->packed_blocks.get_stats();
+}
+
 } } } // namespace morphene::plugins::p2p
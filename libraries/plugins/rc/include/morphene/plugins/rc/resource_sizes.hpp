@@ -59,6 +59,9 @@ struct state_object_size_info
    int64_t witness_vote_object_base_size      = 40     *STATE_BYTES_SCALE;
 };
 
+// Execution times are in nanoseconds.
+// This table can be regenerated from a replay with programs/util/calibrate_rc_exec_times
+
 struct operation_exec_info
 {
    int64_t account_create_operation_exec_time                  =  57700;
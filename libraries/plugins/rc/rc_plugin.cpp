@@ -1,4 +1,6 @@
 
+#define BOOST_THREAD_PROVIDES_FUTURE
+
 #include <morphene/plugins/block_data_export/block_data_export_plugin.hpp>
 
 #include <morphene/plugins/rc/rc_curve.hpp>
@@ -13,6 +15,9 @@
 
 #include <morphene/jsonball/jsonball.hpp>
 
+#include <boost/thread/future.hpp>
+#include <boost/thread/sync_bounded_queue.hpp>
+
 #define MORPHENE_RC_REGEN_TIME   (60*60*24*5)
 #define MORPHENE_HISTORICAL_ACCOUNT_CREATION_ADJUSTMENT      293313625
 
@@ -24,6 +29,9 @@
 // 2 / ( 24 * 5 ) = 0.01666...
 #define MORPHENE_RC_MAX_NEGATIVE_PERCENT 166
 
+// Blocks with fewer transactions than this are counted on the write thread
+#define MORPHENE_RC_PARALLEL_COUNT_MIN_TXS 32
+
 namespace morphene { namespace plugins { namespace rc {
 
 using morphene::plugins::block_data_export::block_data_export_plugin;
@@ -33,12 +41,25 @@ namespace detail {
 using chain::plugin_exception;
 using morphene::chain::util::manabar_params;
 
+//
+// A contiguous range of block transactions whose resources are counted by a worker thread.
+//
+struct count_work_item
+{
+   const signed_transaction*        begin = nullptr;
+   const signed_transaction*        end = nullptr;
+   count_resources_result*          result = nullptr;
+   boost::promise< void >           done_promise;
+   boost::future< void >            done_future = done_promise.get_future();
+};
+
 class rc_plugin_impl
 {
    public:
       rc_plugin_impl( rc_plugin& _plugin ) :
          _db( appbase::app().get_plugin< morphene::plugins::chain::chain_plugin >().db() ),
-         _self( _plugin )
+         _self( _plugin ),
+         _count_queue( _max_count_queue_size )
       {
          _skip.skip_reject_not_enough_rc = 0;
          _skip.skip_deduct_rc = 0;
@@ -46,6 +67,7 @@ class rc_plugin_impl
          _skip.skip_reject_unknown_delta_vests = 1;
       }
 
+      void on_pre_apply_block( const block_notification& note );
       void on_post_apply_block( const block_notification& note );
       //void on_pre_apply_transaction( const transaction_notification& note );
       void on_post_apply_transaction( const transaction_notification& note );
@@ -55,6 +77,13 @@ class rc_plugin_impl
       void on_first_block();
       void validate_database();
 
+      void count_block_resources( const signed_block& block );
+      const count_resources_result* find_block_tx_count( const signed_transaction& tx )const;
+
+      void start_threads();
+      void stop_threads();
+      void count_thread_main();
+
       bool before_first_block()
       {
          return (_db.count< rc_account_object >() == 0);
@@ -67,6 +96,16 @@ class rc_plugin_impl
       std::map< account_name_type, int64_t > _account_to_max_rc;
       uint32_t                      _enable_at_block = 1;
 
+      // Per-transaction resource counts of the block being applied, computed at block receipt
+      std::vector< count_resources_result >  _block_tx_counts;
+      const signed_transaction*     _block_txs = nullptr;
+
+      size_t                        _num_count_threads = 0;
+      size_t                        _max_count_queue_size = 100;
+      boost::concurrent::sync_bounded_queue< std::shared_ptr< count_work_item > >   _count_queue;
+      std::vector< boost::thread >  _count_threads;
+
+      boost::signals2::connection   _pre_apply_block_conn;
       boost::signals2::connection   _post_apply_block_conn;
       boost::signals2::connection   _pre_apply_transaction_conn;
       boost::signals2::connection   _post_apply_transaction_conn;
@@ -327,7 +366,11 @@ void rc_plugin_impl::on_post_apply_transaction( const transaction_notification&
    rc_transaction_info tx_info;
 
    // How many resources does the transaction use?
-   count_resources( note.transaction, tx_info.usage );
+   const count_resources_result* block_tx_count = find_block_tx_count( note.transaction );
+   if( block_tx_count != nullptr )
+      tx_info.usage = *block_tx_count;
+   else
+      count_resources( note.transaction, tx_info.usage );
 
    // How many RC does this transaction cost?
    const rc_resource_param_object& params_obj = _db.get< rc_resource_param_object, by_id >( rc_resource_param_object::id_type() );
@@ -363,8 +406,126 @@ void rc_plugin_impl::on_post_apply_transaction( const transaction_notification&
       export_data->tx_info.push_back( tx_info );
 }
 
+void rc_plugin_impl::start_threads()
+{
+   for( size_t i=0; i<_num_count_threads; i++ )
+   {
+      _count_threads.emplace_back( [this]() { count_thread_main(); } );
+   }
+}
+
+void rc_plugin_impl::stop_threads()
+{
+   _count_queue.close();
+   for( boost::thread& t : _count_threads )
+      t.join();
+   _count_threads.clear();
+}
+
+void rc_plugin_impl::count_thread_main()
+{
+   while( true )
+   {
+      std::shared_ptr< count_work_item > work;
+      try
+      {
+         _count_queue.pull_front( work );
+      }
+      catch( const boost::concurrent::sync_queue_is_closed& e )
+      {
+         break;
+      }
+
+      try
+      {
+         count_resources_result* result = work->result;
+         for( const signed_transaction* tx = work->begin; tx != work->end; ++tx, ++result )
+            count_resources( *tx, *result );
+         work->done_promise.set_value();
+      }
+      catch( ... )
+      {
+         work->done_promise.set_exception( boost::current_exception() );
+      }
+   }
+}
+
+//
+// Resource counting only depends on the transaction itself, so the whole block can be
+// counted up front, split across the worker threads. The write thread counts the first
+// range itself and waits for the rest before any transaction is applied, so the work
+// never outlives the block even if it fails to apply.
+//
+void rc_plugin_impl::count_block_resources( const signed_block& block )
+{
+   const size_t num_txs = block.transactions.size();
+
+   _block_tx_counts.clear();
+   _block_tx_counts.resize( num_txs );
+   _block_txs = block.transactions.data();
+
+   const signed_transaction* txs = block.transactions.data();
+   count_resources_result* results = _block_tx_counts.data();
+
+   if( num_txs < MORPHENE_RC_PARALLEL_COUNT_MIN_TXS || _count_threads.empty() )
+   {
+      for( size_t i=0; i<num_txs; i++ )
+         count_resources( txs[i], results[i] );
+      return;
+   }
+
+   const size_t num_ranges = _count_threads.size() + 1;
+   const size_t range_size = (num_txs + num_ranges - 1) / num_ranges;
+
+   std::vector< std::shared_ptr< count_work_item > > work;
+   for( size_t start = range_size; start < num_txs; start += range_size )
+   {
+      std::shared_ptr< count_work_item > item = std::make_shared< count_work_item >();
+      item->begin = txs + start;
+      item->end = txs + std::min( start + range_size, num_txs );
+      item->result = results + start;
+      _count_queue.push_back( item );
+      work.push_back( item );
+   }
+
+   for( size_t i=0; i<range_size; i++ )
+      count_resources( txs[i], results[i] );
+
+   for( const std::shared_ptr< count_work_item >& item : work )
+      item->done_future.get();
+}
+
+const count_resources_result* rc_plugin_impl::find_block_tx_count( const signed_transaction& tx )const
+{
+   if( _block_txs == nullptr || !_db.is_processing_block() )
+      return nullptr;
+
+   std::less< const signed_transaction* > less;
+   if( less( &tx, _block_txs ) || !less( &tx, _block_txs + _block_tx_counts.size() ) )
+      return nullptr;
+
+   return &_block_tx_counts[ &tx - _block_txs ];
+}
+
+void rc_plugin_impl::on_pre_apply_block( const block_notification& note )
+{
+   _block_tx_counts.clear();
+   _block_txs = nullptr;
+
+   if( before_first_block() && (note.block_num != _enable_at_block) )
+      return;
+
+   count_block_resources( note.block );
+}
+
 void rc_plugin_impl::on_post_apply_block( const block_notification& note )
 {
+   std::vector< count_resources_result > block_tx_counts;
+   block_tx_counts.swap( _block_tx_counts );
+   bool has_block_tx_counts = (_block_txs == note.block.transactions.data())
+                           && (block_tx_counts.size() == note.block.transactions.size());
+   _block_txs = nullptr;
+
    const dynamic_global_property_object& gpo = _db.get_dynamic_global_properties();
    if( before_first_block() )
    {
@@ -408,9 +569,20 @@ void rc_plugin_impl::on_post_apply_block( const block_notification& note )
 
    // How many resources did transactions use?
    count_resources_result count;
-   for( const signed_transaction& tx : note.block.transactions )
+   if( has_block_tx_counts )
+   {
+      for( const count_resources_result& tx_count : block_tx_counts )
+      {
+         for( size_t i=0; i<MORPHENE_NUM_RESOURCE_TYPES; i++ )
+            count.resource_count[i] += tx_count.resource_count[i];
+      }
+   }
+   else
    {
-      count_resources( tx, count );
+      for( const signed_transaction& tx : note.block.transactions )
+      {
+         count_resources( tx, count );
+      }
    }
 
    const witness_schedule_object& wso = _db.get_witness_schedule_object();
@@ -888,6 +1060,7 @@ void rc_plugin::set_program_options( options_description& cli, options_descripti
    cfg.add_options()
       ("rc-skip-reject-not-enough-rc", bpo::value<bool>()->default_value( false ), "Skip rejecting transactions when account has insufficient RCs. This is not recommended." )
       ("rc-compute-historical-rc", bpo::value<bool>()->default_value( false ), "Generate historical resource credits" )
+      ("rc-resource-count-threads", bpo::value<uint32_t>()->default_value( 2 ), "Number of worker threads used to count transaction resources of incoming blocks (0 to count on the write thread)" )
       ;
    cli.add_options()
       ("rc-skip-reject-not-enough-rc", bpo::bool_switch()->default_value( false ), "Skip rejecting transactions when account has insufficient RCs. This is not recommended." )
@@ -913,6 +1086,8 @@ void rc_plugin::plugin_initialize( const boost::program_options::variables_map&
 
       chain::database& db = appbase::app().get_plugin< morphene::plugins::chain::chain_plugin >().db();
 
+      my->_pre_apply_block_conn = db.add_pre_apply_block_handler( [&]( const block_notification& note )
+         { try { my->on_pre_apply_block( note ); } FC_LOG_AND_RETHROW() }, *this, 0 );
       my->_post_apply_block_conn = db.add_post_apply_block_handler( [&]( const block_notification& note )
          { try { my->on_post_apply_block( note ); } FC_LOG_AND_RETHROW() }, *this, 0 );
       //my->_pre_apply_transaction_conn = db.add_pre_apply_transaction_handler( [&]( const transaction_notification& note )
@@ -936,6 +1111,9 @@ void rc_plugin::plugin_initialize( const boost::program_options::variables_map&
       }
 #endif
       ilog( "RC's will be computed starting at block ${b}", ("b", my->_enable_at_block) );
+
+      my->_num_count_threads = options.at( "rc-resource-count-threads" ).as< uint32_t >();
+      my->start_threads();
    }
    FC_CAPTURE_AND_RETHROW()
 }
@@ -944,11 +1122,14 @@ void rc_plugin::plugin_startup() {}
 
 void rc_plugin::plugin_shutdown()
 {
+   chain::util::disconnect_signal( my->_pre_apply_block_conn );
    chain::util::disconnect_signal( my->_post_apply_block_conn );
    // chain::util::disconnect_signal( my->_pre_apply_transaction_conn );
    chain::util::disconnect_signal( my->_post_apply_transaction_conn );
    chain::util::disconnect_signal( my->_pre_apply_operation_conn );
    chain::util::disconnect_signal( my->_post_apply_operation_conn );
+
+   my->stop_threads();
 }
 
 void rc_plugin::set_rc_plugin_skip_flags( rc_plugin_skip_flags skip )
@@ -4,9 +4,19 @@
 
 #include <boost/algorithm/string.hpp>
 
-#include <sstream>
-
-#include "StatsdClient.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "UDPSender.hpp"
 
 namespace morphene { namespace plugins { namespace statsd {
 
@@ -14,12 +24,297 @@ using namespace Statsd;
 
 namespace detail
 {
-   inline std::string compose_key( const std::string& ns, const std::string& stat, const std::string& key )
+   enum metric_type : uint8_t
    {
-      std::stringstream ss;
-      ss << ns << '.' << stat << '.' << key;
-      return ss.str();
-   }
+      counter_metric,
+      gauge_metric,
+      timer_metric
+   };
+
+   /// A metric as recorded by the thread that produced it, with its key already composed
+   struct metric_event
+   {
+      static const size_t max_key_size = 118;
+
+      char           key[ max_key_size ];
+      uint8_t        key_size = 0;
+      metric_type    type = counter_metric;
+      int64_t        value = 0;
+   };
+
+   /**
+    * A fixed ring of metrics written by one thread and read by the aggregator thread.  Neither
+    * side takes a lock; when the ring is full new metrics are dropped and counted.
+    *
+    * push() returns how many metrics are waiting after the push, or 0 if it was dropped.
+    */
+   class metric_buffer
+   {
+      public:
+         static const size_t capacity = 1024;
+
+         size_t push( const std::string& ns, const std::string& stat, const std::string& key, metric_type type, int64_t value )
+         {
+            size_t tail = _tail.load( std::memory_order_relaxed );
+            size_t waiting = tail - _head.load( std::memory_order_acquire );
+            size_t key_size = ns.size() + stat.size() + key.size() + 2;
+            if( waiting == capacity || key_size > metric_event::max_key_size )
+            {
+               _dropped.fetch_add( 1, std::memory_order_relaxed );
+               return 0;
+            }
+
+            metric_event& e = _events[ tail % capacity ];
+            char* out = e.key;
+            memcpy( out, ns.data(), ns.size() );
+            out += ns.size();
+            *out++ = '.';
+            memcpy( out, stat.data(), stat.size() );
+            out += stat.size();
+            *out++ = '.';
+            memcpy( out, key.data(), key.size() );
+            e.key_size = uint8_t( key_size );
+            e.type = type;
+            e.value = value;
+
+            _tail.store( tail + 1, std::memory_order_release );
+            return waiting + 1;
+         }
+
+         template< typename Lambda >
+         void drain( Lambda&& l )
+         {
+            size_t head = _head.load( std::memory_order_relaxed );
+            size_t tail = _tail.load( std::memory_order_acquire );
+            for( ; head != tail; ++head )
+               l( _events[ head % capacity ] );
+            _head.store( head, std::memory_order_release );
+         }
+
+         uint64_t take_dropped() { return _dropped.exchange( 0, std::memory_order_relaxed ); }
+
+      private:
+         std::array< metric_event, capacity >   _events;
+         std::atomic< size_t >                  _head{ 0 };
+         std::atomic< size_t >                  _tail{ 0 };
+         std::atomic< uint64_t >                _dropped{ 0 };
+   };
+
+   /**
+    * Collects metrics from every recording thread and sends them to statsd from a background
+    * thread.  Recording a metric only copies it into the calling thread's metric_buffer.  The
+    * background thread drains the buffers every few milliseconds, or sooner when one of them
+    * is half full, and combines what it finds:
+    * counters are summed, the last value of a gauge is kept and timings are counted in a
+    * histogram.  Once per flush interval the totals are written out, packed into datagrams of
+    * up to datagram_size bytes and, if it is not 0, batchsize metrics.
+    *
+    * Because nothing is sampled away locally, every metric is counted and sampling frequencies
+    * are not used.  A histogram bucket is sent as a single timing with a sample rate of one over
+    * its count, which statsd expands back into that many timings.
+    */
+   class metric_aggregator
+   {
+      public:
+         metric_aggregator( const std::string& host, uint16_t port, const std::string& prefix, uint32_t datagram_size, uint32_t batchsize, uint32_t flush_interval_ms ) :
+            _id( ++next_id ),
+            _prefix( prefix ),
+            _datagram_size( datagram_size ),
+            _batchsize( batchsize ),
+            _flush_interval( flush_interval_ms ),
+            _sender( host, port )
+         {
+            _thread = std::thread( [this]() { run(); } );
+         }
+
+         ~metric_aggregator()
+         {
+            {
+               std::lock_guard< std::mutex > lock( _wake_mutex );
+               _stopping = true;
+            }
+            _wake_cond.notify_all();
+            _thread.join();
+         }
+
+         void record( const std::string& ns, const std::string& stat, const std::string& key, metric_type type, int64_t value ) noexcept
+         {
+            if( local_buffer().push( ns, stat, key, type, value ) == metric_buffer::capacity / 2 )
+            {
+               _drain_requested = true;
+               _wake_cond.notify_one();
+            }
+         }
+
+      private:
+         /// How often the thread buffers are emptied, independently of the flush interval
+         static constexpr std::chrono::milliseconds drain_interval{ 20 };
+
+         /** Timings are kept exactly below 16ms and to their 4 leading bits above, within 12.5% */
+         static uint32_t timer_bucket( uint32_t ms )
+         {
+            uint32_t shift = 0;
+            for( uint32_t v = ms; v >= 16; v >>= 1 )
+               ++shift;
+            return ( ms >> shift ) << shift;
+         }
+
+         metric_buffer& local_buffer()
+         {
+            // Keyed by aggregator id so a restarted plugin does not reuse a buffer it no longer reads
+            static thread_local uint64_t                          owner = 0;
+            static thread_local std::shared_ptr< metric_buffer >  buffer;
+
+            if( owner != _id )
+            {
+               buffer = std::make_shared< metric_buffer >();
+               owner = _id;
+               std::lock_guard< std::mutex > lock( _buffers_mutex );
+               _buffers.push_back( buffer );
+            }
+            return *buffer;
+         }
+
+         void run()
+         {
+            auto next_flush = std::chrono::steady_clock::now() + _flush_interval;
+            bool stopping = false;
+
+            while( !stopping )
+            {
+               {
+                  std::unique_lock< std::mutex > lock( _wake_mutex );
+                  _wake_cond.wait_for( lock, drain_interval, [this]() { return _stopping || _drain_requested.exchange( false ); } );
+                  stopping = _stopping;
+               }
+
+               drain();
+
+               if( stopping || std::chrono::steady_clock::now() >= next_flush )
+               {
+                  flush();
+                  next_flush = std::chrono::steady_clock::now() + _flush_interval;
+               }
+            }
+         }
+
+         void drain()
+         {
+            std::vector< std::shared_ptr< metric_buffer > > buffers;
+            {
+               std::lock_guard< std::mutex > lock( _buffers_mutex );
+               buffers = _buffers;
+
+               // A buffer only referenced by _buffers and this copy belongs to a thread that has
+               // exited.  It is drained one last time below and then released.
+               _buffers.erase( std::remove_if( _buffers.begin(), _buffers.end(),
+                  []( const std::shared_ptr< metric_buffer >& b ) { return b.use_count() == 2; } ), _buffers.end() );
+            }
+
+            std::string key;
+            for( const auto& b : buffers )
+            {
+               b->drain( [&]( const metric_event& e )
+               {
+                  key.assign( e.key, e.key_size );
+                  switch( e.type )
+                  {
+                     case counter_metric:
+                        _counters[ key ] += e.value;
+                        break;
+                     case gauge_metric:
+                        _gauges[ key ] = e.value;
+                        break;
+                     case timer_metric:
+                        ++_timers[ key ][ timer_bucket( uint32_t( e.value ) ) ];
+                        break;
+                  }
+               } );
+               _dropped += b->take_dropped();
+            }
+         }
+
+         void flush()
+         {
+            std::string datagram;
+            uint32_t metrics_in_datagram = 0;
+            char line[ 256 ];
+
+            auto append = [&]( int size )
+            {
+               if( size <= 0 )
+                  return;
+               if( !datagram.empty() &&
+                   ( datagram.size() + 1 + size > _datagram_size || ( _batchsize && metrics_in_datagram >= _batchsize ) ) )
+               {
+                  _sender.send( datagram );
+                  datagram.clear();
+                  metrics_in_datagram = 0;
+               }
+               if( !datagram.empty() )
+                  datagram += '\n';
+               datagram.append( line, std::min< size_t >( size, sizeof( line ) - 1 ) );
+               ++metrics_in_datagram;
+            };
+
+            for( const auto& c : _counters )
+               append( snprintf( line, sizeof( line ), "%s%s:%" PRId64 "|c", _prefix.c_str(), c.first.c_str(), c.second ) );
+
+            for( const auto& g : _gauges )
+               append( snprintf( line, sizeof( line ), "%s%s:%" PRId64 "|g", _prefix.c_str(), g.first.c_str(), g.second ) );
+
+            for( const auto& t : _timers )
+            {
+               for( const auto& bucket : t.second )
+               {
+                  if( bucket.second == 1 )
+                     append( snprintf( line, sizeof( line ), "%s%s:%u|ms", _prefix.c_str(), t.first.c_str(), bucket.first ) );
+                  else
+                     append( snprintf( line, sizeof( line ), "%s%s:%u|ms|@%.6g", _prefix.c_str(), t.first.c_str(), bucket.first, 1.0 / bucket.second ) );
+               }
+            }
+
+            if( _dropped )
+            {
+               append( snprintf( line, sizeof( line ), "%sstatsd.dropped:%" PRIu64 "|c", _prefix.c_str(), _dropped ) );
+               _dropped = 0;
+            }
+
+            if( !datagram.empty() )
+               _sender.send( datagram );
+
+            // Counters and timings restart every interval, gauges keep their last value
+            _counters.clear();
+            _timers.clear();
+         }
+
+         static std::atomic< uint64_t >                            next_id;
+
+         const uint64_t                                            _id;
+         const std::string                                         _prefix;
+         const uint32_t                                            _datagram_size;
+         const uint32_t                                            _batchsize;
+         const std::chrono::milliseconds                           _flush_interval;
+
+         std::mutex                                                _buffers_mutex;
+         std::vector< std::shared_ptr< metric_buffer > >           _buffers;
+
+         // Only used by the aggregator thread
+         UDPSender                                                 _sender;
+         std::map< std::string, int64_t >                          _counters;
+         std::map< std::string, int64_t >                          _gauges;
+         std::map< std::string, std::map< uint32_t, uint64_t > >   _timers;
+         uint64_t                                                  _dropped = 0;
+
+         std::mutex                                                _wake_mutex;
+         std::condition_variable                                   _wake_cond;
+         bool                                                      _stopping = false;
+         std::atomic< bool >                                       _drain_requested{ false };
+         std::thread                                               _thread;
+   };
+
+   std::atomic< uint64_t > metric_aggregator::next_id{ 0 };
+   constexpr std::chrono::milliseconds metric_aggregator::drain_interval;
 
    class statsd_plugin_impl
    {
@@ -47,9 +342,11 @@ namespace detail
          std::map< std::string, std::set< std::string > >   _stat_list;
 
          fc::optional< fc::ip::endpoint >                   _statsd_endpoint;
-         uint32_t                                           _statsd_batchsize = 1;
+         uint32_t                                           _statsd_datagram_size = 1432;
+         uint32_t                                           _statsd_batchsize = 0;
+         uint32_t                                           _statsd_flush_interval_ms = 1000;
 
-         std::unique_ptr< StatsdClient >                    _statsd;
+         std::unique_ptr< metric_aggregator >               _statsd;
    };
 
    void statsd_plugin_impl::start()
@@ -68,7 +365,7 @@ namespace detail
          port = _statsd_endpoint->port();
       }
 
-      _statsd.reset( new StatsdClient( host, port, "morphened.", _statsd_batchsize ) );
+      _statsd.reset( new metric_aggregator( host, port, "morphened.", _statsd_datagram_size, _statsd_batchsize, _statsd_flush_interval_ms ) );
       _started = true;
    }
 
@@ -109,31 +406,31 @@ namespace detail
    void statsd_plugin_impl::increment( const std::string& ns, const std::string& stat, const std::string& key, const float frequency ) const noexcept
    {
       if( !filter_by_namespace( ns, stat ) ) return;
-      _statsd->increment( compose_key( ns, stat, key ), frequency );
+      _statsd->record( ns, stat, key, counter_metric, 1 );
    }
 
    void statsd_plugin_impl::decrement( const std::string& ns, const std::string& stat, const std::string& key, const float frequency ) const noexcept
    {
       if( !filter_by_namespace( ns, stat ) ) return;
-      _statsd->decrement( compose_key( ns, stat, key ), frequency );
+      _statsd->record( ns, stat, key, counter_metric, -1 );
    }
 
    void statsd_plugin_impl::count( const std::string& ns, const std::string& stat, const std::string& key, const int64_t delta, const float frequency ) const noexcept
    {
       if( !filter_by_namespace( ns, stat ) ) return;
-      _statsd->count( compose_key( ns, stat, key ), delta, frequency );
+      _statsd->record( ns, stat, key, counter_metric, delta );
    }
 
    void statsd_plugin_impl::gauge( const std::string& ns, const std::string& stat, const std::string& key, const uint64_t value, const float frequency ) const noexcept
    {
       if( !filter_by_namespace( ns, stat ) ) return;
-      _statsd->gauge( compose_key( ns, stat, key ), value, frequency );
+      _statsd->record( ns, stat, key, gauge_metric, int64_t( value ) );
    }
 
    void statsd_plugin_impl::timing( const std::string& ns, const std::string& stat, const std::string& key, const uint32_t ms, const float frequency ) const noexcept
    {
       if( !filter_by_namespace( ns, stat ) ) return;
-      _statsd->timing( compose_key( ns, stat, key ), ms, frequency );
+      _statsd->record( ns, stat, key, timer_metric, ms );
    }
 }
 
@@ -147,13 +444,21 @@ void statsd_plugin::set_program_options( options_description& cli, options_descr
 
    cfg.add_options()
       ("statsd-endpoint", bpo::value< std::string >(), "Endpoint to send statsd messages to.")
-      ("statsd-batchsize", bpo::value< uint32_t >()->default_value( 1 ), "Size to batch statsd messages." )
+      ("statsd-batchsize", bpo::value< uint32_t >(), "Maximum number of metrics in a statsd datagram, only limited by statsd-datagram-size if not set." )
+      ("statsd-datagram-size", bpo::value< uint32_t >()->default_value( 1432 ), "Maximum size in bytes of a statsd datagram. Metrics are packed together up to this size." )
+      ("statsd-flush-interval", bpo::value< uint32_t >()->default_value( 1000 ), "Milliseconds between sending aggregated statsd metrics." )
       ("statsd-whitelist", bpo::value< vector< std::string > >()->composing(), "Whitelist of statistics to capture.")
       ("statsd-blacklist", bpo::value< vector< std::string > >()->composing(), "Blacklist of statistics to capture.");
 }
 
 void statsd_plugin::plugin_initialize( const boost::program_options::variables_map& options )
 {
+   if( options.count( "statsd-batchsize" ) )
+      my->_statsd_batchsize = options.at( "statsd-batchsize" ).as< uint32_t >();
+   my->_statsd_datagram_size = options.at( "statsd-datagram-size" ).as< uint32_t >();
+   my->_statsd_flush_interval_ms = options.at( "statsd-flush-interval" ).as< uint32_t >();
+   FC_ASSERT( my->_statsd_flush_interval_ms > 0, "statsd-flush-interval must be positive" );
+
    if( options.count( "statsd-endpoint" ) )
    {
       auto statsd_endpoint = options.at( "statsd-endpoint" ).as< string >();
@@ -214,8 +214,10 @@ void webserver_plugin_impl::handle_ws_message( websocket_server_type* server, co
       {
          if( msg->get_opcode() == websocketpp::frame::opcode::text )
             con->send( api->call( msg->get_payload() ) );
+         else if( msg->get_opcode() == websocketpp::frame::opcode::binary )
+            con->send( api->call_raw( msg->get_payload() ), websocketpp::frame::opcode::binary );
          else
-            con->send( "error: string payload expected" );
+            con->send( "error: string or binary payload expected" );
       }
       catch( fc::exception& e )
       {
@@ -605,7 +605,7 @@ void witness_plugin::start_mining(
 
     auto head_block_num  = b.block.block_num();
     auto head_block_time = b.block.timestamp;
-    auto block_id = b.block.id();
+    auto block_id = b.block_id;
 
     // fc::thread* mainthread = &fc::thread::current();
 
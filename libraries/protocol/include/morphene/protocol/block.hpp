@@ -7,6 +7,8 @@ namespace morphene { namespace protocol {
    struct signed_block : public signed_block_header
    {
       checksum_type calculate_merkle_root()const;
+      /// Computes the merkle root from already computed transaction merkle digests
+      static checksum_type calculate_merkle_root( vector<digest_type> transaction_digests );
       vector<signed_transaction> transactions;
    };
 
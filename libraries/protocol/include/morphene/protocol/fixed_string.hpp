@@ -190,19 +190,39 @@ using fixed_string = typename fixed_string_impl_for_size<N>::t;
 
 namespace fc { namespace raw {
 
+// Packed as a std::string, but written straight from the big endian storage without allocating one
 template< typename Stream, typename Storage >
 inline void pack( Stream& s, const morphene::protocol::fixed_string_impl< Storage >& u )
 {
-   pack( s, std::string( u ) );
+   Storage d = boost::endian::native_to_big( u.data );
+   uint32_t size = strnlen( (const char*)&d, sizeof(d) );
+   pack( s, unsigned_int( size ) );
+   if( size )
+      s.write( (const char*)&d, size );
 }
 
 template< typename Stream, typename Storage >
 inline void unpack( Stream& s, morphene::protocol::fixed_string_impl< Storage >& u, uint32_t depth )
 {
    depth++;
-   std::string str;
-   unpack( s, str, depth );
-   u = str;
+   unsigned_int size;
+   unpack( s, size, depth );
+
+   if( size.value > sizeof(Storage) )
+   {
+      // Longer strings are truncated, as assigning a std::string would
+      FC_ASSERT( size.value < MAX_ARRAY_ALLOC_SIZE );
+      std::string str( size.value, '\0' );
+      s.read( &str[0], size.value );
+      u = str;
+      return;
+   }
+
+   Storage d;
+   memset( (char*)&d, 0, sizeof(d) );
+   if( size.value )
+      s.read( (char*)&d, size.value );
+   u.data = boost::endian::big_to_native( d );
 }
 
 } // raw
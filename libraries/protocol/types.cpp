@@ -47,8 +47,10 @@ namespace morphene { namespace protocol {
        binary_key k;
        k.data = key_data;
        k.check = fc::ripemd160::hash( k.data.data, k.data.size() )._hash[0];
-       auto data = fc::raw::pack_to_vector( k );
-       return MORPHENE_ADDRESS_PREFIX + fc::to_base58( data.data(), data.size() );
+       char data[ sizeof( k.data ) + sizeof( k.check ) ];
+       fc::datastream< char* > ds( data, sizeof( data ) );
+       fc::raw::pack( ds, k );
+       return MORPHENE_ADDRESS_PREFIX + fc::to_base58( data, sizeof( data ) );
     }
 
     bool operator == ( const public_key_type& p1, const fc::ecc::public_key& p2)
@@ -0,0 +1,91 @@
+/**
+ * Measures base58 encoding and decoding of key sized payloads, both through fc directly and
+ * through public_key_type's string conversions, which every key in a JSON request or
+ * response goes through.
+ *
+ * Usage: base58_benchmark [iterations]
+ */
+
+#include <morphene/protocol/types.hpp>
+
+#include <fc/crypto/base58.hpp>
+#include <fc/crypto/elliptic.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using morphene::protocol::public_key_type;
+
+template< typename Lambda >
+void run( const char* name, uint32_t iterations, Lambda&& l )
+{
+   size_t checksum = 0;
+   fc::time_point start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      checksum += l( i );
+   double seconds = double( ( fc::time_point::now() - start ).count() ) / 1000000;
+
+   std::cout << "   " << std::left << std::setw( 32 ) << name << std::right
+             << std::setw( 10 ) << seconds * 1000000000 / iterations << " ns/op"
+             << std::setw( 14 ) << iterations / seconds << " ops/s"
+             << ( checksum == 0 ? " (empty)" : "" ) << "\n";
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t iterations = argc > 1 ? std::stoul( argv[1] ) : 200000;
+
+      const size_t num_keys = 64;
+      std::vector< public_key_type > keys;
+      std::vector< std::string > key_strings;
+      std::vector< std::vector< char > > payloads_33;
+      std::vector< std::vector< char > > payloads_37;
+      std::vector< std::string > encoded_37;
+      for( size_t i = 0; i < num_keys; ++i )
+      {
+         auto priv = fc::ecc::private_key::regenerate( fc::sha256::hash( std::to_string( i ) ) );
+         keys.emplace_back( priv.get_public_key() );
+         key_strings.push_back( std::string( keys.back() ) );
+
+         const fc::ecc::public_key_data data = keys.back();
+         payloads_33.emplace_back( data.begin(), data.end() );
+         payloads_37.push_back( payloads_33.back() );
+         payloads_37.back().resize( 37, char( i ) );
+         encoded_37.push_back( fc::to_base58( payloads_37.back() ) );
+      }
+
+      std::cout << std::fixed << std::setprecision( 1 );
+      run( "to_base58 (33 bytes)", iterations, [&]( uint32_t i ) {
+         return fc::to_base58( payloads_33[ i % num_keys ] ).size();
+      } );
+      run( "to_base58 (37 bytes)", iterations, [&]( uint32_t i ) {
+         return fc::to_base58( payloads_37[ i % num_keys ] ).size();
+      } );
+      run( "from_base58 (37 bytes)", iterations, [&]( uint32_t i ) {
+         return fc::from_base58( encoded_37[ i % num_keys ] ).size();
+      } );
+      run( "from_base58 into buffer", iterations, [&]( uint32_t i ) {
+         char buf[37];
+         return fc::from_base58( encoded_37[ i % num_keys ], buf, sizeof( buf ) );
+      } );
+      run( "public_key_type to string", iterations, [&]( uint32_t i ) {
+         return std::string( keys[ i % num_keys ] ).size();
+      } );
+      run( "public_key_type from string", iterations, [&]( uint32_t i ) {
+         return size_t( public_key_type( key_strings[ i % num_keys ] ).key_data.data[1] ) + 1;
+      } );
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * Replays a range of the block log with the advanced benchmark enabled and prints an
+ * operation_exec_info table (see morphene/plugins/rc/resource_sizes.hpp) built from the
+ * measured evaluator times, annotated with confidence intervals and measured state growth.
+ *
+ * Usage: calibrate_rc_exec_times <data-dir> <start-block> <stop-block> [shared-file-size-gb]
+ *
+ * <data-dir> must contain a block_log. A scratch shared memory file is created in a
+ * temporary directory and removed on exit.
+ */
+
+#include <morphene/chain/database.hpp>
+#include <morphene/plugins/rc/resource_sizes.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using morphene::chain::database;
+using morphene::chain::util::advanced_benchmark_dumper;
+using morphene::plugins::rc::operation_exec_info;
+
+// Two sided 95% confidence interval under the normal approximation
+#define CALIBRATION_Z_SCORE 1.96
+
+struct op_measurement
+{
+   uint64_t count = 0;
+   double   mean_time = 0;
+   double   time_ci = 0;
+   double   mean_state_bytes = 0;
+};
+
+struct exec_info_field_visitor
+{
+   exec_info_field_visitor( const operation_exec_info& i ) : info( i ) {}
+
+   template< typename Member, class Class, Member (Class::*member) >
+   void operator()( const char* name )const
+   {
+      fields.emplace_back( name, info.*member );
+   }
+
+   const operation_exec_info& info;
+   mutable std::vector< std::pair< std::string, int64_t > > fields;
+};
+
+std::string short_op_name( const std::string& name )
+{
+   std::string result = name;
+   size_t pos = result.rfind( "--->" );
+   if( pos != std::string::npos )
+      result = result.substr( pos + 4 );
+   pos = result.rfind( "::" );
+   if( pos != std::string::npos )
+      result = result.substr( pos + 2 );
+   return result;
+}
+
+std::map< std::string, op_measurement > collect_measurements( const advanced_benchmark_dumper& dumper )
+{
+   std::map< std::string, op_measurement > result;
+   for( const advanced_benchmark_dumper::item& it : dumper.get_info().items )
+   {
+      // Only evaluator timings are relevant, plugin notifications are recorded under other names
+      if( it.op_name.find( "apply_context--->" ) != 0 || it.count == 0 )
+         continue;
+
+      op_measurement& m = result[ short_op_name( it.op_name ) + "_exec_time" ];
+      double n = double( it.count );
+      m.count = it.count;
+      m.mean_time = double( it.time ) / n;
+      m.mean_state_bytes = double( it.state_bytes ) / n;
+
+      if( it.count > 1 )
+      {
+         double variance = ( it.time_squared - n * m.mean_time * m.mean_time ) / ( n - 1 );
+         m.time_ci = CALIBRATION_Z_SCORE * std::sqrt( std::max( variance, 0.0 ) / n );
+      }
+   }
+   return result;
+}
+
+void print_exec_info_table( const std::map< std::string, op_measurement >& measurements )
+{
+   operation_exec_info current;
+   exec_info_field_visitor vtor( current );
+   fc::reflector< operation_exec_info >::visit( vtor );
+
+   std::cout << "struct operation_exec_info\n{\n";
+   for( const auto& field : vtor.fields )
+   {
+      auto it = measurements.find( field.first );
+      std::cout << "   int64_t " << std::left << std::setw( 60 ) << field.first << "= " << std::right << std::setw( 6 );
+      if( it == measurements.end() )
+      {
+         std::cout << field.second << ";   // no samples, unchanged\n";
+         continue;
+      }
+
+      const op_measurement& m = it->second;
+      std::cout << int64_t( std::llround( m.mean_time ) ) << ";   // n=" << m.count
+                << ", 95% CI [" << int64_t( m.mean_time - m.time_ci ) << ", " << int64_t( m.mean_time + m.time_ci ) << "]"
+                << ", was " << field.second
+                << ", state bytes/op " << std::fixed << std::setprecision( 1 ) << m.mean_state_bytes << "\n";
+   }
+   std::cout << "};\n";
+
+   for( const auto& m : measurements )
+   {
+      bool known = false;
+      for( const auto& field : vtor.fields )
+         known = known || (field.first == m.first);
+      if( !known )
+         std::cerr << "Measured " << m.first << " (n=" << m.second.count << ", mean " << int64_t( m.second.mean_time )
+                   << " ns) has no entry in operation_exec_info\n";
+   }
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      if( argc < 4 )
+      {
+         std::cerr << "Usage: " << argv[0] << " <data-dir> <start-block> <stop-block> [shared-file-size-gb]\n";
+         return 1;
+      }
+
+      fc::temp_directory shared_mem_dir( fc::temp_directory_path() );
+
+      database::open_args args;
+      args.data_dir = fc::path( argv[1] );
+      args.shared_mem_dir = shared_mem_dir.path();
+      args.benchmark_is_enabled = true;
+      args.benchmark_start_at = std::stoul( argv[2] );
+      args.stop_replay_at = std::stoul( argv[3] );
+      args.shared_file_size = uint64_t( argc > 4 ? std::stoul( argv[4] ) : 8 ) * 1024 * 1024 * 1024;
+
+      database db;
+      db.reindex( args );
+
+      print_exec_info_table( collect_measurements( db.get_benchmark_dumper() ) );
+
+      db.close();
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
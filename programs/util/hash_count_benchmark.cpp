@@ -0,0 +1,123 @@
+/**
+ * Counts the SHA-256 and SHA-224 hashes computed while a node applies a block, including block
+ * ids, header digests, transaction ids and merkle leaves.
+ *
+ * Blocks of transfers are generated on one database and pushed to a second, and only the push
+ * to the second is counted.  Witness and transaction signatures are not checked, so the
+ * digests they sign are not counted.
+ *
+ * Usage: hash_count_benchmark [blocks] [transactions-per-block...]
+ *
+ * 20 blocks each of 0, 1, 10, 100 and 1000 transactions are used unless sizes are given.
+ * Hashes are only counted when built with COUNT_HASHES=ON.
+ */
+
+#include <morphene/chain/database.hpp>
+#include <morphene/protocol/morphene_operations.hpp>
+
+#include <fc/crypto/sha224.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/filesystem.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using morphene::chain::database;
+using morphene::protocol::legacy_asset;
+using morphene::protocol::signed_block;
+using morphene::protocol::signed_transaction;
+using morphene::protocol::transfer_operation;
+
+static const uint32_t benchmark_skip = database::skip_witness_signature | database::skip_transaction_signatures;
+
+uint64_t hash_count()
+{
+   return fc::sha256::hash_count() + fc::sha224::hash_count();
+}
+
+void open_database( database& db, const fc::temp_directory& dir )
+{
+   database::open_args args;
+   args.data_dir = dir.path();
+   args.shared_mem_dir = dir.path() / "blockchain";
+   args.shared_file_size = uint64_t( 1024 ) * 1024 * 1024;
+   db.open( args );
+}
+
+signed_block generate_block( database& db, uint32_t transactions, uint32_t& next_memo )
+{
+   for( uint32_t i = 0; i < transactions; ++i )
+   {
+      transfer_operation op;
+      op.from = MORPHENE_INIT_WITNESS_NAME;
+      op.to = MORPHENE_TEMP_ACCOUNT;
+      op.amount = legacy_asset( 1, MORPH_SYMBOL );
+      op.memo = "transfer #" + std::to_string( next_memo++ );
+
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      trx.set_expiration( db.head_block_time() + MORPHENE_MAX_TIME_UNTIL_EXPIRATION / 2 );
+      trx.set_reference_block( db.head_block_id() );
+      db.push_transaction( trx, benchmark_skip );
+   }
+
+   return db.generate_block( db.get_slot_time( 1 ), db.get_scheduled_witness( 1 ),
+      fc::ecc::private_key::regenerate( fc::sha256::hash( std::string( "hash_count_benchmark" ) ) ), benchmark_skip );
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t blocks = argc > 1 ? std::stoul( argv[1] ) : 20;
+      std::vector< uint32_t > sizes;
+      for( int i = 2; i < argc; ++i )
+         sizes.push_back( std::stoul( argv[i] ) );
+      if( sizes.empty() )
+         sizes = { 0, 1, 10, 100, 1000 };
+
+#ifndef FC_COUNT_HASHES
+      std::cerr << "Built without COUNT_HASHES, every count will be 0\n";
+#endif
+
+      fc::temp_directory producer_dir( fc::temp_directory_path() );
+      fc::temp_directory applier_dir( fc::temp_directory_path() );
+      database producer;
+      database applier;
+      open_database( producer, producer_dir );
+      open_database( applier, applier_dir );
+
+      uint32_t next_memo = 0;
+      std::cout << std::fixed << std::setprecision( 1 );
+      for( uint32_t size : sizes )
+      {
+         uint64_t hashes = 0;
+         for( uint32_t i = 0; i < blocks; ++i )
+         {
+            signed_block block = generate_block( producer, size, next_memo );
+            FC_ASSERT( block.transactions.size() == size, "Only ${n} of ${size} transactions fit in the block",
+               ("n", block.transactions.size())("size", size) );
+
+            uint64_t start = hash_count();
+            applier.push_block( block, benchmark_skip );
+            hashes += hash_count() - start;
+         }
+
+         std::cout << std::setw( 6 ) << size << " transactions: " << std::setw( 10 ) << double( hashes ) / blocks
+                   << " hashes per applied block\n";
+      }
+
+      producer.close();
+      applier.close();
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Measures fc::json::from_string throughput on the documents a node parses most: JSON-RPC
+ * requests carrying a signed transaction, and get_block style replies carrying a full block.
+ * Each payload is parsed with every fc::json::parse_type.
+ *
+ * Usage: json_parse_benchmark [iterations] [transactions-per-block] [json-file...]
+ *
+ * Any json files given are benchmarked as additional payloads, so captured API traffic or
+ * a dumped block can be measured as well.
+ */
+
+#include <morphene/protocol/block.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/fstream.hpp>
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using morphene::protocol::legacy_asset;
+using morphene::protocol::signed_block;
+using morphene::protocol::signed_transaction;
+using morphene::protocol::transfer_operation;
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = uint16_t( n );
+   trx.ref_block_prefix = 0x12345678u + n;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation op;
+   op.from = "alice" + std::to_string( n % 97 );
+   op.to = "bob" + std::to_string( n % 89 );
+   op.amount = legacy_asset( 1000 + n, MORPH_SYMBOL );
+   op.memo = "payment #" + std::to_string( n ) + " for \"services\"\nthank you";
+   trx.operations.push_back( op );
+
+   morphene::protocol::signature_type sig;
+   for( size_t i = 0; i < sig.size(); ++i )
+      sig.data[i] = (unsigned char)( i * 7 + n );
+   trx.signatures.push_back( sig );
+   return trx;
+}
+
+std::string make_rpc_request( const signed_transaction& trx )
+{
+   return fc::json::to_string( fc::mutable_variant_object()
+      ( "jsonrpc", "2.0" )
+      ( "id", 1 )
+      ( "method", "network_broadcast_api.broadcast_transaction" )
+      ( "params", fc::mutable_variant_object( "trx", trx ) ) );
+}
+
+std::string make_block_reply( uint32_t num_transactions )
+{
+   signed_block block;
+   block.timestamp = fc::time_point_sec( 1500000000 );
+   block.witness = "initminer";
+   for( uint32_t i = 0; i < num_transactions; ++i )
+      block.transactions.push_back( make_transaction( i ) );
+   block.transaction_merkle_root = block.calculate_merkle_root();
+
+   return fc::json::to_string( fc::mutable_variant_object()
+      ( "jsonrpc", "2.0" )
+      ( "result", fc::mutable_variant_object( "block", block ) )
+      ( "id", 1 ) );
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t iterations = argc > 1 ? std::stoul( argv[1] ) : 1000;
+      uint32_t transactions_per_block = argc > 2 ? std::stoul( argv[2] ) : 200;
+
+      std::vector< std::pair< std::string, std::string > > payloads;
+      payloads.emplace_back( "broadcast_transaction request", make_rpc_request( make_transaction( 1 ) ) );
+      payloads.emplace_back( "get_block reply", make_block_reply( transactions_per_block ) );
+      for( int i = 3; i < argc; ++i )
+      {
+         std::string contents;
+         fc::read_file_contents( fc::path( argv[i] ), contents );
+         payloads.emplace_back( argv[i], contents );
+      }
+
+      const std::vector< std::pair< fc::json::parse_type, const char* > > parsers = {
+         { fc::json::legacy_parser, "legacy" },
+         { fc::json::legacy_parser_with_string_doubles, "legacy_with_string_doubles" },
+         { fc::json::strict_parser, "strict" },
+         { fc::json::relaxed_parser, "relaxed" }
+      };
+
+      std::cout << std::fixed << std::setprecision( 1 );
+      for( const auto& payload : payloads )
+      {
+         std::cout << payload.first << " (" << payload.second.size() << " bytes)\n";
+         for( const auto& parser : parsers )
+         {
+            size_t checksum = 0;
+            fc::time_point start = fc::time_point::now();
+            for( uint32_t i = 0; i < iterations; ++i )
+               checksum += fc::json::from_string( payload.second, parser.first ).is_null() ? 0 : 1;
+            double seconds = double( ( fc::time_point::now() - start ).count() ) / 1000000;
+
+            double megabytes = double( payload.second.size() ) * iterations / ( 1024 * 1024 );
+            std::cout << "   " << std::left << std::setw( 28 ) << parser.second << std::right
+                      << std::setw( 10 ) << megabytes / seconds << " MB/s "
+                      << std::setw( 12 ) << iterations / seconds << " docs/s"
+                      << ( checksum == iterations ? "" : " (null results)" ) << "\n";
+         }
+      }
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Measures computing the transaction merkle root of large blocks, serially through
+ * signed_block::calculate_merkle_root and in parallel through hashed_block, both from scratch
+ * and with the transaction digests already cached.
+ *
+ * Usage: merkle_benchmark [iterations] [transactions-per-block...]
+ *
+ * Blocks of 1000, 2000, 5000 and 10000 transactions are used unless sizes are given.
+ */
+
+#include <morphene/chain/hashed_block.hpp>
+#include <morphene/protocol/block.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using morphene::chain::hashed_block;
+using morphene::protocol::checksum_type;
+using morphene::protocol::legacy_asset;
+using morphene::protocol::signed_block;
+using morphene::protocol::signed_transaction;
+using morphene::protocol::transfer_operation;
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = uint16_t( n );
+   trx.ref_block_prefix = 0x12345678u + n;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation op;
+   op.from = "alice" + std::to_string( n % 97 );
+   op.to = "bob" + std::to_string( n % 89 );
+   op.amount = legacy_asset( 1000 + n, MORPH_SYMBOL );
+   op.memo = "payment #" + std::to_string( n );
+   trx.operations.push_back( op );
+
+   morphene::protocol::signature_type sig;
+   for( size_t i = 0; i < sig.size(); ++i )
+      sig.data[i] = (unsigned char)( i * 7 + n );
+   trx.signatures.push_back( sig );
+   return trx;
+}
+
+template< typename Lambda >
+void run( const char* name, uint32_t iterations, const checksum_type& expected, Lambda&& l )
+{
+   bool matches = true;
+   fc::time_point start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      matches &= l() == expected;
+   double seconds = double( ( fc::time_point::now() - start ).count() ) / 1000000;
+
+   std::cout << "   " << std::left << std::setw( 28 ) << name << std::right
+             << std::setw( 10 ) << seconds * 1000000 / iterations << " us/block"
+             << ( matches ? "" : " (merkle root mismatch)" ) << "\n";
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t iterations = argc > 1 ? std::stoul( argv[1] ) : 20;
+      std::vector< uint32_t > sizes;
+      for( int i = 2; i < argc; ++i )
+         sizes.push_back( std::stoul( argv[i] ) );
+      if( sizes.empty() )
+         sizes = { 1000, 2000, 5000, 10000 };
+
+      std::cout << std::fixed << std::setprecision( 1 );
+      for( uint32_t size : sizes )
+      {
+         signed_block block;
+         for( uint32_t i = 0; i < size; ++i )
+            block.transactions.push_back( make_transaction( i ) );
+         checksum_type expected = block.calculate_merkle_root();
+
+         std::cout << size << " transactions\n";
+         run( "serial", iterations, expected, [&]() { return block.calculate_merkle_root(); } );
+         run( "hashed_block", iterations, expected, [&]() { return hashed_block( block ).merkle_root(); } );
+
+         hashed_block cached( block );
+         for( const auto& trx : cached.transactions() )
+            trx.merkle_digest();
+         run( "hashed_block, cached leaves", iterations, expected, [&]()
+         {
+            return hashed_block::merkle_root( cached.transactions() );
+         } );
+      }
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
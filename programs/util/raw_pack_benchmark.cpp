@@ -0,0 +1,146 @@
+/**
+ * Measures fc::raw pack_size, pack and unpack of signed blocks, which the chain does for
+ * every block it applies, produces or writes to the block log.
+ *
+ * Usage: raw_pack_benchmark [iterations] [transactions-per-block] [block_log-dir [num-blocks]]
+ *
+ * If a block_log directory is given, the last num-blocks blocks of it (default 1000) are
+ * benchmarked in addition to the generated block.
+ */
+
+#include <morphene/chain/block_log.hpp>
+#include <morphene/protocol/block.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/raw.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using morphene::chain::block_log;
+using morphene::protocol::legacy_asset;
+using morphene::protocol::signed_block;
+using morphene::protocol::signed_transaction;
+using morphene::protocol::transfer_operation;
+
+signed_transaction make_transaction( uint32_t n )
+{
+   signed_transaction trx;
+   trx.ref_block_num = uint16_t( n );
+   trx.ref_block_prefix = 0x12345678u + n;
+   trx.expiration = fc::time_point_sec( 1500000000 + n );
+
+   transfer_operation op;
+   op.from = "alice" + std::to_string( n % 97 );
+   op.to = "bob" + std::to_string( n % 89 );
+   op.amount = legacy_asset( 1000 + n, MORPH_SYMBOL );
+   op.memo = "payment #" + std::to_string( n );
+   trx.operations.push_back( op );
+
+   morphene::protocol::signature_type sig;
+   for( size_t i = 0; i < sig.size(); ++i )
+      sig.data[i] = (unsigned char)( i * 7 + n );
+   trx.signatures.push_back( sig );
+   return trx;
+}
+
+signed_block make_block( uint32_t num_transactions )
+{
+   signed_block block;
+   block.timestamp = fc::time_point_sec( 1500000000 );
+   block.witness = "initminer";
+   for( uint32_t i = 0; i < num_transactions; ++i )
+      block.transactions.push_back( make_transaction( i ) );
+   block.transaction_merkle_root = block.calculate_merkle_root();
+   return block;
+}
+
+void run( const std::string& name, const std::vector< signed_block >& blocks, uint32_t iterations )
+{
+   std::vector< std::vector< char > > packed;
+   size_t total_bytes = 0;
+   for( const auto& b : blocks )
+   {
+      packed.push_back( fc::raw::pack_to_vector( b ) );
+      total_bytes += packed.back().size();
+   }
+
+   std::cout << name << " (" << blocks.size() << " blocks, " << total_bytes << " bytes)\n";
+
+   auto report = [&]( const char* op, fc::time_point start, size_t checksum )
+   {
+      double seconds = double( ( fc::time_point::now() - start ).count() ) / 1000000;
+      double megabytes = double( total_bytes ) * iterations / ( 1024 * 1024 );
+      std::cout << "   " << std::left << std::setw( 16 ) << op << std::right
+                << std::setw( 10 ) << megabytes / seconds << " MB/s "
+                << std::setw( 12 ) << blocks.size() * iterations / seconds << " blocks/s"
+                << ( checksum == total_bytes * iterations ? "" : " (size mismatch)" ) << "\n";
+   };
+
+   size_t checksum = 0;
+   fc::time_point start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      for( const auto& b : blocks )
+         checksum += fc::raw::pack_size( b );
+   report( "pack_size", start, checksum );
+
+   checksum = 0;
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+      for( const auto& b : blocks )
+         checksum += fc::raw::pack_to_vector( b ).size();
+   report( "pack", start, checksum );
+
+   checksum = 0;
+   start = fc::time_point::now();
+   for( uint32_t i = 0; i < iterations; ++i )
+   {
+      for( const auto& p : packed )
+      {
+         signed_block b;
+         fc::raw::unpack_from_vector( p, b );
+         checksum += p.size();
+      }
+   }
+   report( "unpack", start, checksum );
+}
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t iterations = argc > 1 ? std::stoul( argv[1] ) : 100;
+      uint32_t transactions_per_block = argc > 2 ? std::stoul( argv[2] ) : 1000;
+
+      std::cout << std::fixed << std::setprecision( 1 );
+      run( "generated block", { make_block( transactions_per_block ) }, iterations );
+
+      if( argc > 3 )
+      {
+         uint32_t num_blocks = argc > 4 ? std::stoul( argv[4] ) : 1000;
+
+         block_log log;
+         log.open( fc::path( argv[3] ) / "block_log" );
+         uint32_t head_num = log.head() ? log.head()->block_num() : 0;
+
+         std::vector< signed_block > blocks;
+         for( uint32_t n = head_num > num_blocks ? head_num - num_blocks + 1 : 1; n <= head_num; ++n )
+         {
+            auto b = log.read_block_by_num( n );
+            if( b )
+               blocks.push_back( *b );
+         }
+
+         run( std::string( argv[3] ) + "/block_log", blocks, iterations );
+      }
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * Measures encrypted stcp_socket throughput over loopback.
+ *
+ * All connections are driven from the main fc thread, the way the p2p thread drives peer
+ * connections, so the result shows how much a single cooperative thread can push through
+ * the AES channel and how the crypto threads spread that work.
+ *
+ * Usage: stcp_benchmark [connections] [megabytes-per-connection] [write-size-bytes]
+ */
+
+#include <graphene/net/stcp_socket.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/network/ip.hpp>
+#include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using graphene::net::stcp_socket;
+
+struct connection_result
+{
+   fc::time_point start;
+   fc::time_point end;
+};
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      uint32_t num_connections = argc > 1 ? std::stoul( argv[1] ) : 4;
+      uint64_t megabytes = argc > 2 ? std::stoull( argv[2] ) : 256;
+      size_t write_size = argc > 3 ? std::stoul( argv[3] ) : 1024 * 1024;
+
+      // stcp works in whole AES blocks
+      write_size = ( ( write_size + 15 ) / 16 ) * 16;
+      uint64_t bytes_per_connection = megabytes * 1024 * 1024;
+      uint64_t writes_per_connection = ( bytes_per_connection + write_size - 1 ) / write_size;
+      bytes_per_connection = writes_per_connection * write_size;
+
+      fc::tcp_server server;
+      server.listen( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), 0 ) );
+      fc::ip::endpoint server_endpoint( fc::ip::address( "127.0.0.1" ), server.get_port() );
+
+      std::vector< std::shared_ptr< stcp_socket > > senders;
+      std::vector< std::shared_ptr< stcp_socket > > receivers;
+      for( uint32_t i = 0; i < num_connections; ++i )
+      {
+         auto sender = std::make_shared< stcp_socket >();
+         auto receiver = std::make_shared< stcp_socket >();
+         fc::future< void > accepted = fc::async( [&]()
+         {
+            server.accept( receiver->get_socket() );
+            receiver->accept();
+         }, "stcp_benchmark accept" );
+         sender->connect_to( server_endpoint );
+         accepted.wait();
+         senders.push_back( sender );
+         receivers.push_back( receiver );
+      }
+
+      std::shared_ptr< char > plaintext( new char[ write_size ], []( char* p ){ delete[] p; } );
+      for( size_t i = 0; i < write_size; ++i )
+         plaintext.get()[i] = char( i );
+
+      std::vector< connection_result > results( num_connections );
+      std::vector< fc::future< void > > tasks;
+      fc::time_point benchmark_start = fc::time_point::now();
+
+      for( uint32_t i = 0; i < num_connections; ++i )
+      {
+         tasks.push_back( fc::async( [&, i]()
+         {
+            for( uint64_t w = 0; w < writes_per_connection; ++w )
+               senders[i]->write( plaintext.get(), write_size );
+            senders[i]->flush();
+         }, "stcp_benchmark send" ) );
+
+         tasks.push_back( fc::async( [&, i]()
+         {
+            std::unique_ptr< char[] > received( new char[ write_size ] );
+            results[i].start = fc::time_point::now();
+            for( uint64_t w = 0; w < writes_per_connection; ++w )
+               receivers[i]->read( received.get(), write_size );
+            results[i].end = fc::time_point::now();
+         }, "stcp_benchmark receive" ) );
+      }
+
+      for( auto& task : tasks )
+         task.wait();
+
+      fc::microseconds total_time = fc::time_point::now() - benchmark_start;
+      double megabytes_per_connection = double( bytes_per_connection ) / ( 1024 * 1024 );
+
+      std::cout << std::fixed << std::setprecision( 1 );
+      for( uint32_t i = 0; i < num_connections; ++i )
+      {
+         double seconds = double( ( results[i].end - results[i].start ).count() ) / 1000000;
+         std::cout << "connection " << i << ": " << megabytes_per_connection / seconds << " MB/s\n";
+      }
+      std::cout << "aggregate: " << megabytes_per_connection * num_connections / ( double( total_time.count() ) / 1000000 )
+                << " MB/s over " << num_connections << " connections, " << write_size << " byte writes\n";
+
+      for( uint32_t i = 0; i < num_connections; ++i )
+      {
+         senders[i]->close();
+         receivers[i]->close();
+      }
+      server.close();
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+
+   return 0;
+}